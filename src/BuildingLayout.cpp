@@ -0,0 +1,190 @@
+#include "BuildingLayout.h"
+#include <QStringList>
+#include <algorithm>
+
+BuildingLayout::BuildingLayout(int numFloors, int numElevators) : numFloors(numFloors), numElevators(numElevators)
+{
+    CarGroup group;
+    group.name = "all";
+    group.numElevators = numElevators;
+    group.served.resize(numFloors);
+    for (int floor = 1; floor <= numFloors; floor++)
+    {
+        group.floors.push_back(floor);
+        group.served.set(floor);
+    }
+    groups.push_back(group);
+    plan();
+}
+
+bool BuildingLayout::parse(const QString &text, QString &error)
+{
+    QVector<CarGroup> parsed;
+    int top = 0;
+    int cars = 0;
+    for (const QString &part : text.split(';'))
+    {
+        QStringList fields = part.trimmed().split(':');
+        if (fields.size() != 3 || fields[0].isEmpty())
+        {
+            error = "group " + part + " is not name:cars:floors.";
+            return false;
+        }
+        CarGroup group;
+        group.name = fields[0];
+        bool ok = true;
+        group.numElevators = fields[1].toInt(&ok);
+        if (!ok || group.numElevators < 1)
+        {
+            error = "group " + group.name + " needs at least one car.";
+            return false;
+        }
+        for (const QString &floors : fields[2].split(','))
+        {
+            // a floor or a range of floors
+            int dash = floors.indexOf('-');
+            int low = (dash == -1 ? floors : floors.left(dash)).toInt(&ok);
+            int high = ok && dash != -1 ? floors.mid(dash + 1).toInt(&ok) : low;
+            if (!ok || low < 1 || high < low)
+            {
+                error = "group " + group.name + " has bad floors " + floors + ".";
+                return false;
+            }
+            for (int floor = low; floor <= high; floor++)
+            {
+                group.floors.push_back(floor);
+            }
+        }
+        std::sort(group.floors.begin(), group.floors.end());
+        group.floors.erase(std::unique(group.floors.begin(), group.floors.end()), group.floors.end());
+        if (group.floors.size() < 2)
+        {
+            error = "group " + group.name + " has to serve at least two floors.";
+            return false;
+        }
+        top = qMax(top, group.floors.last());
+        cars += group.numElevators;
+        parsed.push_back(group);
+    }
+
+    for (CarGroup &group : parsed)
+    {
+        group.served.resize(top);
+        for (int floor : group.floors)
+        {
+            group.served.set(floor);
+        }
+    }
+    groups = parsed;
+    numFloors = top;
+    numElevators = cars;
+    plan();
+
+    // everyone has to be able to get everywhere
+    for (int floor = 1; floor <= numFloors; floor++)
+    {
+        if (floorGroups[floor].isEmpty())
+        {
+            error = "no group serves floor " + QString::number(floor) + ".";
+            return false;
+        }
+    }
+    for (int from = 0; from < groups.size(); from++)
+    {
+        for (int to = 0; to < groups.size(); to++)
+        {
+            if (rides[from * groups.size() + to] == -1)
+            {
+                error = "groups " + groups[from].name + " and " + groups[to].name + " have no floors to change at between them.";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void BuildingLayout::plan()
+{
+    int count = groups.size();
+    floorGroups.fill(QVector<int>(), numFloors + 1);
+    for (int group = 0; group < count; group++)
+    {
+        for (int floor : groups[group].floors)
+        {
+            floorGroups[floor].push_back(group);
+        }
+    }
+
+    // floors each pair of groups can change at
+    sharedFloors.fill(FloorBitset(), count * count);
+    for (int a = 0; a < count; a++)
+    {
+        for (int b = 0; b < count; b++)
+        {
+            FloorBitset &shared = sharedFloors[a * count + b];
+            shared.resize(numFloors);
+            for (int floor : groups[a].floors)
+            {
+                if (groups[b].served.test(floor))
+                {
+                    shared.set(floor);
+                }
+            }
+        }
+    }
+
+    // a breadth first search from every group gives the fewest rides and the first change
+    rides.fill(-1, count * count);
+    nextGroups.fill(-1, count * count);
+    for (int from = 0; from < count; from++)
+    {
+        QVector<int> queue;
+        queue.push_back(from);
+        rides[from * count + from] = 0;
+        nextGroups[from * count + from] = from;
+        for (int i = 0; i < queue.size(); i++)
+        {
+            int group = queue[i];
+            for (int other = 0; other < count; other++)
+            {
+                if (rides[from * count + other] != -1 || sharedFloors[group * count + other].isEmpty())
+                {
+                    continue;
+                }
+                rides[from * count + other] = rides[from * count + group] + 1;
+                nextGroups[from * count + other] = group == from ? other : nextGroups[from * count + group];
+                queue.push_back(other);
+            }
+        }
+    }
+}
+
+void BuildingLayout::route(int from, int to, int &group, int &alight) const
+{
+    // the groups at both ends with the fewest rides between them, the first one wins a tie
+    int count = groups.size();
+    int best = -1;
+    int last = -1;
+    for (int start : floorGroups[from])
+    {
+        for (int end : floorGroups[to])
+        {
+            int needed = rides[start * count + end];
+            if (needed != -1 && (best == -1 || needed < rides[best * count + last]))
+            {
+                best = start;
+                last = end;
+            }
+        }
+    }
+    group = best;
+    if (best == last)
+    {
+        alight = to;
+        return;
+    }
+
+    // change at the shared floor closest to where the passenger is going
+    int next = nextGroups[best * count + last];
+    alight = sharedFloors[best * count + next].nearest(to);
+}
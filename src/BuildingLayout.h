@@ -0,0 +1,76 @@
+#ifndef BUILDINGLAYOUT_H
+#define BUILDINGLAYOUT_H
+
+#include "FloorBitset.h"
+#include <QString>
+#include <QVector>
+
+// a bank of cars with its own controller, serving only its own floors
+struct CarGroup
+{
+    QString name;
+    int numElevators;
+    QVector<int> floors; // served floors from the bottom up
+    FloorBitset served;
+};
+
+// the car groups of a building and how to get between any two floors with them.
+// written as name:cars:floors for each group, separated by semicolons, with floors as a comma
+// separated list of floors and ranges, for example
+//   low:8:1-20;high:8:1,21-40;shuttle:2:1,41;sky:6:41-80
+// every floor up to the top one has to be served, and every group has to be reachable from
+// every other one through floors they share, like lobbies and sky lobbies.
+// a passenger rides the fewest groups to their floor and changes at a shared floor.
+// routes are worked out between groups up front, so finding one never looks at the cars
+class BuildingLayout
+{
+private:
+    QVector<CarGroup> groups;
+    int numFloors = 0;
+    int numElevators = 0;
+    QVector<QVector<int>> floorGroups; // groups serving each floor, indexed by floor
+    QVector<int> rides;                // fewest groups to ride from one group to another, indexed [from * groups + to]
+    QVector<int> nextGroups;           // the group to change to first on the way
+    QVector<FloorBitset> sharedFloors; // floors two groups both serve
+
+    void plan();
+
+public:
+    BuildingLayout() {}
+
+    // one group of cars serving every floor
+    BuildingLayout(int numFloors, int numElevators);
+
+    bool parse(const QString &text, QString &error);
+
+    int getNumFloors() const { return numFloors; }
+
+    int getNumElevators() const { return numElevators; }
+
+    int getNumGroups() const { return groups.size(); }
+
+    const CarGroup &getGroup(int group) const { return groups[group]; }
+
+    // the group to board at floor from, and where to get off it, on the way to floor to
+    void route(int from, int to, int &group, int &alight) const;
+};
+
+#endif // BUILDINGLAYOUT_H
+
+// get uml format for this class like this:
+
+// -groups: QVector<CarGroup>
+// -numFloors: int
+// -numElevators: int
+// -floorGroups: QVector<QVector<int>>
+// -rides: QVector<int>
+// -nextGroups: QVector<int>
+// -sharedFloors: QVector<FloorBitset>
+
+// +parse(const QString &, QString &): bool
+// +getNumFloors(): int
+// +getNumElevators(): int
+// +getNumGroups(): int
+// +getGroup(int): CarGroup
+// +route(int, int, int &, int &)
+// -plan()
@@ -0,0 +1,206 @@
+#include "CallTrace.h"
+#include <cstring>
+
+namespace
+{
+// digits up to the next comma or the end of the line, false if there are none or anything else
+bool parseNumber(const char *&p, const char *end, qint64 &value)
+{
+    const char *start = p;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        // 18 digits always fit
+        if (p - start == 18)
+        {
+            return false;
+        }
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    return p != start && (p == end || *p == ',');
+}
+
+// true and skipped if the text up to the next comma or the end of the line is exactly text
+bool fieldIs(const char *&p, const char *end, const char *text)
+{
+    size_t length = strlen(text);
+    if (size_t(end - p) < length || memcmp(p, text, length) != 0 || (p + length != end && p[length] != ','))
+    {
+        return false;
+    }
+    p += length;
+    return true;
+}
+}
+
+const qint64 CallTrace::windowBytes;
+
+bool CallTrace::open(const QString &fileName, QString &error)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = "cannot read " + fileName + ": " + file.errorString();
+        return false;
+    }
+    fileSize = file.size();
+    if (fileSize > 0 && !mapFrom(0))
+    {
+        error = "cannot map " + fileName + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CallTrace::mapFrom(qint64 offset)
+{
+    // only one window is mapped at a time, pages already read can be dropped by the system
+    if (window != nullptr)
+    {
+        file.unmap(window);
+        window = nullptr;
+    }
+    qint64 length = qMin(windowBytes, fileSize - offset);
+    if (length <= 0)
+    {
+        cursor = windowEnd = nullptr;
+        return false;
+    }
+    window = file.map(offset, length);
+    if (window == nullptr)
+    {
+        cursor = windowEnd = nullptr;
+        return false;
+    }
+    windowStart = offset;
+    cursor = reinterpret_cast<const char *>(window);
+    windowEnd = cursor + length;
+    return true;
+}
+
+bool CallTrace::nextLine(const char *&line, const char *&lineEnd)
+{
+    while (cursor != nullptr)
+    {
+        const char *newline = static_cast<const char *>(memchr(cursor, '\n', size_t(windowEnd - cursor)));
+        bool lastWindow = windowStart + (windowEnd - reinterpret_cast<const char *>(window)) >= fileSize;
+        if (newline != nullptr || lastWindow)
+        {
+            line = cursor;
+            lineEnd = newline != nullptr ? newline : windowEnd;
+            cursor = newline != nullptr ? newline + 1 : windowEnd;
+            if (cursor == windowEnd && lastWindow)
+            {
+                // keep the line readable until the next call, then stop
+                cursor = nullptr;
+            }
+            if (lineEnd > line && lineEnd[-1] == '\r')
+            {
+                lineEnd--;
+            }
+            return true;
+        }
+
+        // the line runs past the window, map again from where it starts
+        qint64 lineStart = windowStart + (cursor - reinterpret_cast<const char *>(window));
+        if (cursor == reinterpret_cast<const char *>(window))
+        {
+            // a whole window without a newline is not a call, skip to the next newline
+            skipped++;
+            qint64 offset = windowStart + windowBytes;
+            while (mapFrom(offset))
+            {
+                const char *found = static_cast<const char *>(memchr(cursor, '\n', size_t(windowEnd - cursor)));
+                if (found != nullptr)
+                {
+                    cursor = found + 1;
+                    break;
+                }
+                offset += windowBytes;
+            }
+            continue;
+        }
+        mapFrom(lineStart);
+    }
+    return false;
+}
+
+bool CallTrace::parse(const char *line, const char *lineEnd, TraceCall &call) const
+{
+    const char *p = line;
+    qint64 time;
+    qint64 floor;
+    if (!parseNumber(p, lineEnd, time) || p++ == lineEnd)
+    {
+        return false;
+    }
+    bool hall = fieldIs(p, lineEnd, "hall");
+    if (!hall && !fieldIs(p, lineEnd, "car"))
+    {
+        return false;
+    }
+    if (p++ == lineEnd || !parseNumber(p, lineEnd, floor) || p++ == lineEnd || floor < 1 || floor > numFloors)
+    {
+        return false;
+    }
+    call.time = time;
+    call.floor = int(floor);
+    call.elevatorId = 0;
+    call.dir = direction::up;
+    if (hall)
+    {
+        bool up = fieldIs(p, lineEnd, "up");
+        if (!up && !fieldIs(p, lineEnd, "down"))
+        {
+            return false;
+        }
+        call.dir = up ? direction::up : direction::down;
+
+        // nothing above the top floor or below the bottom one
+        return p == lineEnd && !(up && floor == numFloors) && !(!up && floor == 1);
+    }
+    qint64 elevatorId;
+    if (!parseNumber(p, lineEnd, elevatorId) || p != lineEnd || elevatorId < 1 || elevatorId > numElevators)
+    {
+        return false;
+    }
+    call.elevatorId = int(elevatorId);
+    return true;
+}
+
+bool CallTrace::next(TraceCall &call)
+{
+    const char *line;
+    const char *lineEnd;
+    while (nextLine(line, lineEnd))
+    {
+        // headers, comments and blank lines
+        if (line == lineEnd || *line < '0' || *line > '9')
+        {
+            continue;
+        }
+        if (!parse(line, lineEnd, call))
+        {
+            skipped++;
+            continue;
+        }
+
+        // times count from the first call, so logs can use any epoch
+        if (firstTime == -1)
+        {
+            firstTime = call.time;
+        }
+        call.time = qMax<qint64>(0, call.time - firstTime);
+        return true;
+    }
+    return false;
+}
+
+CallTrace::~CallTrace()
+{
+    if (window != nullptr)
+    {
+        file.unmap(window);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef CALLTRACE_H
+#define CALLTRACE_H
+
+#include "enums.h"
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+// one call from a building's controller log
+struct TraceCall
+{
+    qint64 time;    // milliseconds since the first call in the trace
+    int floor;
+    int elevatorId; // car the call was made in, 0 for a hall call
+    direction dir;  // hall calls only
+};
+
+// reads hall and car calls from a csv log one at a time, for logs far too big to load.
+// the file is memory mapped a window at a time and each line is parsed straight out of the
+// mapping, so memory use stays the same however long the log is. lines look like
+//   time,hall,floor,up|down
+//   time,car,floor,car
+// with time in milliseconds, counted from the first call. lines that start with anything but
+// a digit are headers or comments, calls that do not parse or do not fit the building are skipped.
+class CallTrace
+{
+private:
+    static const qint64 windowBytes = 64 << 20;
+
+    QFile file;
+    qint64 fileSize = 0;
+    qint64 windowStart = 0; // file offset of the mapped window
+    uchar *window = nullptr;
+    const char *cursor = nullptr;
+    const char *windowEnd = nullptr;
+    int numFloors;
+    int numElevators;
+    qint64 firstTime = -1;
+    int skipped = 0;
+
+    bool mapFrom(qint64 offset);
+    bool nextLine(const char *&line, const char *&lineEnd);
+    bool parse(const char *line, const char *lineEnd, TraceCall &call) const;
+
+public:
+    CallTrace(int numFloors, int numElevators) : numFloors(numFloors), numElevators(numElevators) {}
+
+    ~CallTrace();
+
+    bool open(const QString &fileName, QString &error);
+
+    // the next call in the file, false once there are no more
+    bool next(TraceCall &call);
+
+    // lines that looked like calls but could not be used
+    int getSkipped() const { return skipped; }
+};
+
+#endif // CALLTRACE_H
+
+// get uml format for this class like this:
+
+// -windowBytes: qint64
+// -file: QFile
+// -fileSize: qint64
+// -windowStart: qint64
+// -window: uchar *
+// -cursor: const char *
+// -windowEnd: const char *
+// -numFloors: int
+// -numElevators: int
+// -firstTime: qint64
+// -skipped: int
+
+// +open(const QString &, QString &): bool
+// +next(TraceCall &): bool
+// +getSkipped(): int
+// -mapFrom(qint64): bool
+// -nextLine(const char *&, const char *&): bool
+// -parse(const char *, const char *, TraceCall &): bool
@@ -0,0 +1,68 @@
+#include "CarStateTable.h"
+#include <cstdlib>
+
+CarStateTable::CarStateTable(int numElevators)
+{
+    // every car starts idle with its door closed until it sets its own row
+    floors.assign(numElevators, 1);
+    destinations.assign(numElevators, 1);
+    states.assign(numElevators, elevatorState::idle);
+    doors.assign(numElevators, doorStatus::close);
+    directions.assign(numElevators, direction::up);
+    orderings.assign(numElevators, queueOrdering::look);
+    stops.assign(numElevators, 0);
+    loads.assign(numElevators, 0);
+    capacities.assign(numElevators, 0);
+}
+
+int CarStateTable::openAt(int floor) const
+{
+    // first car standing at the floor with its door open and room inside, or -1
+    int numElevators = size();
+    for (int i = 0; i < numElevators; i++)
+    {
+        if (floors[i] == floor && doors[i] == doorStatus::open && !isFull(i + 1))
+        {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+int CarStateTable::closestHeading(int floor, direction dir) const
+{
+    // closest look car with room, moving the given way and not at the floor yet, or -1
+    elevatorState heading = dir == direction::up ? elevatorState::up : elevatorState::down;
+    int sign = dir == direction::up ? 1 : -1;
+    int closestElevator = -1;
+    int minDistance = 0;
+    int numElevators = size();
+    for (int i = 0; i < numElevators; i++)
+    {
+        int distance = sign * (floor - floors[i]);
+        if (states[i] == heading && orderings[i] == queueOrdering::look && distance > 0 && !isFull(i + 1) && (closestElevator == -1 || distance < minDistance))
+        {
+            minDistance = distance;
+            closestElevator = i + 1;
+        }
+    }
+    return closestElevator;
+}
+
+int CarStateTable::closestIdle(int floor, int first, int step) const
+{
+    // closest idle car among elevators first, first + step, ..., or -1
+    int closestElevator = -1;
+    int minDistance = 0;
+    int numElevators = size();
+    for (int i = first - 1; i < numElevators; i += step)
+    {
+        int distance = abs(floors[i] - floor);
+        if (states[i] == elevatorState::idle && (closestElevator == -1 || distance < minDistance))
+        {
+            minDistance = distance;
+            closestElevator = i + 1;
+        }
+    }
+    return closestElevator;
+}
@@ -0,0 +1,121 @@
+#ifndef CARSTATETABLE_H
+#define CARSTATETABLE_H
+
+#include "enums.h"
+#include <vector>
+
+// the state every car changes on each tick, kept column by column for the whole fleet.
+// scans over the fleet walk a few tightly packed arrays instead of visiting every car object.
+// the table is sized once when the control system is created, so references into it stay valid
+// and each car keeps its own fields as references into its row.
+class CarStateTable
+{
+private:
+    std::vector<int> floors;
+    std::vector<int> destinations;
+    std::vector<elevatorState> states;
+    std::vector<doorStatus> doors;
+    std::vector<direction> directions;
+    std::vector<queueOrdering> orderings;
+    std::vector<int> stops;
+    std::vector<int> loads;
+    std::vector<int> capacities; // 0 for no limit
+
+public:
+    CarStateTable(int numElevators = 0);
+
+    int size() const { return int(floors.size()); }
+
+    // rows are indexed by elevator number, starting at 1
+    int &floor(int elevatorId) { return floors[elevatorId - 1]; }
+
+    int &destination(int elevatorId) { return destinations[elevatorId - 1]; }
+
+    elevatorState &state(int elevatorId) { return states[elevatorId - 1]; }
+
+    doorStatus &door(int elevatorId) { return doors[elevatorId - 1]; }
+
+    direction &travelDirection(int elevatorId) { return directions[elevatorId - 1]; }
+
+    queueOrdering &ordering(int elevatorId) { return orderings[elevatorId - 1]; }
+
+    int &queuedStops(int elevatorId) { return stops[elevatorId - 1]; }
+
+    int &load(int elevatorId) { return loads[elevatorId - 1]; }
+
+    int &capacity(int elevatorId) { return capacities[elevatorId - 1]; }
+
+    int floor(int elevatorId) const { return floors[elevatorId - 1]; }
+
+    int destination(int elevatorId) const { return destinations[elevatorId - 1]; }
+
+    elevatorState state(int elevatorId) const { return states[elevatorId - 1]; }
+
+    doorStatus door(int elevatorId) const { return doors[elevatorId - 1]; }
+
+    int queuedStops(int elevatorId) const { return stops[elevatorId - 1]; }
+
+    int load(int elevatorId) const { return loads[elevatorId - 1]; }
+
+    int capacity(int elevatorId) const { return capacities[elevatorId - 1]; }
+
+    // a full car cannot pick anyone up
+    bool isFull(int elevatorId) const { return capacities[elevatorId - 1] > 0 && loads[elevatorId - 1] >= capacities[elevatorId - 1]; }
+
+    // whole columns, for kernels that work on several cars at once
+    const int *floorData() const { return floors.data(); }
+
+    const int *destinationData() const { return destinations.data(); }
+
+    const elevatorState *stateData() const { return states.data(); }
+
+    const queueOrdering *orderingData() const { return orderings.data(); }
+
+    const int *queuedStopsData() const { return stops.data(); }
+
+    const int *loadData() const { return loads.data(); }
+
+    const int *capacityData() const { return capacities.data(); }
+
+    int openAt(int floor) const;
+
+    int closestHeading(int floor, direction dir) const;
+
+    int closestIdle(int floor, int first, int step) const;
+};
+
+#endif // CARSTATETABLE_H
+
+// get uml format for this class like this:
+
+// -floors: vector<int>
+// -destinations: vector<int>
+// -states: vector<elevatorState>
+// -doors: vector<doorStatus>
+// -directions: vector<direction>
+// -orderings: vector<queueOrdering>
+// -stops: vector<int>
+// -loads: vector<int>
+// -capacities: vector<int>
+
+// +size(): int
+// +floor(int): int
+// +destination(int): int
+// +state(int): elevatorState
+// +door(int): doorStatus
+// +travelDirection(int): direction
+// +ordering(int): queueOrdering
+// +queuedStops(int): int
+// +load(int): int
+// +capacity(int): int
+// +isFull(int): bool
+// +floorData(): int *
+// +destinationData(): int *
+// +stateData(): elevatorState *
+// +orderingData(): queueOrdering *
+// +queuedStopsData(): int *
+// +loadData(): int *
+// +capacityData(): int *
+// +openAt(int): int
+// +closestHeading(int, direction): int
+// +closestIdle(int, int, int): int
@@ -0,0 +1,95 @@
+#include "DestinationQueue.h"
+#include "TraceRecorder.h"
+
+DestinationQueue::DestinationQueue(int numFloors, queueOrdering ordering) : stops(numFloors), ordering(ordering), head(0), length(0)
+{
+    // every floor can be queued at most once
+    if (ordering == queueOrdering::fifo)
+    {
+        order.resize(numFloors + 1);
+    }
+}
+
+bool DestinationQueue::add(int floor)
+{
+    TRACE_SCOPE("DestinationQueue::add");
+
+    // returns false if the floor was already queued
+    if (!stops.set(floor))
+    {
+        return false;
+    }
+
+    if (ordering == queueOrdering::fifo)
+    {
+        order[(head + length) % order.size()] = floor;
+        length++;
+    }
+    return true;
+}
+
+bool DestinationQueue::remove(int floor)
+{
+    if (!stops.reset(floor))
+    {
+        return false;
+    }
+
+    if (ordering == queueOrdering::fifo)
+    {
+        // close the gap left by the floor
+        int i = 0;
+        while (order[(head + i) % order.size()] != floor)
+        {
+            i++;
+        }
+        for (; i < length - 1; i++)
+        {
+            order[(head + i) % order.size()] = order[(head + i + 1) % order.size()];
+        }
+        length--;
+    }
+    return true;
+}
+
+int DestinationQueue::peek(int currentFloor, direction travel) const
+{
+    // next floor to stop at, -1 if there are no stops
+    if (stops.isEmpty())
+    {
+        return -1;
+    }
+
+    if (ordering == queueOrdering::fifo)
+    {
+        return order[head];
+    }
+
+    // keep going the same way while there are stops ahead, a stop at the current floor comes first
+    if (travel == direction::up)
+    {
+        int next = stops.nextAtOrAbove(currentFloor);
+        return next != -1 ? next : stops.nextAtOrBelow(currentFloor);
+    }
+    int next = stops.nextAtOrBelow(currentFloor);
+    return next != -1 ? next : stops.nextAtOrAbove(currentFloor);
+}
+
+int DestinationQueue::take(int currentFloor, direction travel)
+{
+    TRACE_SCOPE("DestinationQueue::take");
+
+    int next = peek(currentFloor, travel);
+    if (next == -1)
+    {
+        return -1;
+    }
+
+    stops.reset(next);
+    if (ordering == queueOrdering::fifo)
+    {
+        head = (head + 1) % order.size();
+        length--;
+    }
+    return next;
+}
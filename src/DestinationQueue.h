@@ -0,0 +1,61 @@
+#ifndef DESTINATIONQUEUE_H
+#define DESTINATIONQUEUE_H
+
+#include "enums.h"
+#include "FloorBitset.h"
+#include <QVector>
+
+// floors an elevator still has to stop at, each floor at most once.
+// look ordering keeps going in the direction of travel while there are stops ahead, then turns around.
+// fifo ordering serves stops in the order they were requested.
+// storage is sized for the building up front, so adding and taking stops never allocates.
+class DestinationQueue
+{
+private:
+    FloorBitset stops;
+    queueOrdering ordering;
+    QVector<int> order; // ring buffer of requested floors, only used for fifo ordering
+    int head;
+    int length;
+
+public:
+    DestinationQueue(int numFloors, queueOrdering ordering);
+
+    queueOrdering getOrdering() const { return ordering; }
+
+    bool add(int floor);
+
+    bool remove(int floor);
+
+    bool contains(int floor) const { return stops.test(floor); }
+
+    int size() const { return stops.count(); }
+
+    bool isEmpty() const { return stops.isEmpty(); }
+
+    int peek(int currentFloor, direction travel) const;
+
+    int take(int currentFloor, direction travel);
+
+    const FloorBitset &floors() const { return stops; }
+};
+
+#endif // DESTINATIONQUEUE_H
+
+// get uml format for this class like this:
+
+// -stops: FloorBitset
+// -ordering: queueOrdering
+// -order: QVector<int>
+// -head: int
+// -length: int
+
+// +getOrdering(): queueOrdering
+// +add(int): bool
+// +remove(int): bool
+// +contains(int): bool
+// +size(): int
+// +isEmpty(): bool
+// +peek(int, direction): int
+// +take(int, direction): int
+// +floors(): FloorBitset
@@ -0,0 +1,142 @@
+#include "DispatchCost.h"
+#include <algorithm>
+#include <cstdlib>
+
+// define ELEVATOR_NO_SIMD to build the plain loop only
+#if defined(__SSE2__) && !defined(ELEVATOR_NO_SIMD)
+#define DISPATCHCOST_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+// the same cost for one car, also used for the cars left over after the last full group of four
+inline int carCost(int car, int destination, elevatorState state, queueOrdering ordering, int stops, int load, int capacity, int floor, elevatorState heading, int sign, int stopCost)
+{
+    if (capacity > 0 && load >= capacity)
+    {
+        return DispatchCost::unavailable;
+    }
+    int distance = abs(car - floor);
+    if (state == elevatorState::idle)
+    {
+        return distance;
+    }
+    if (state == heading && ordering == queueOrdering::look && sign * (floor - car) > 0)
+    {
+        return distance + stops * stopCost;
+    }
+    return abs(car - destination) + abs(destination - floor) + (stops + 1) * stopCost;
+}
+
+#ifdef DISPATCHCOST_SSE2
+// sse2 has no 32 bit abs, min or blend, so they are built from shifts and masks
+inline __m128i absolute(__m128i x)
+{
+    __m128i sign = _mm_srai_epi32(x, 31);
+    return _mm_sub_epi32(_mm_xor_si128(x, sign), sign);
+}
+
+inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#endif
+}
+
+const int DispatchCost::unavailable;
+
+// the state columns are loaded straight into 32 bit lanes
+static_assert(sizeof(elevatorState) == sizeof(int) && sizeof(queueOrdering) == sizeof(int), "car state enums must be int sized");
+
+DispatchCost::DispatchCost(int stopCost)
+{
+    // stop costs are multiplied in 16 bit halves
+    this->stopCost = std::min(std::max(stopCost, 0), 0x7fff);
+}
+
+bool DispatchCost::isVectorised()
+{
+#ifdef DISPATCHCOST_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DispatchCost::evaluate(const CarStateTable &cars, int floor, direction dir, int *costs) const
+{
+    const int *floors = cars.floorData();
+    const int *destinations = cars.destinationData();
+    const elevatorState *states = cars.stateData();
+    const queueOrdering *orderings = cars.orderingData();
+    const int *stops = cars.queuedStopsData();
+    const int *loads = cars.loadData();
+    const int *capacities = cars.capacityData();
+    elevatorState heading = dir == direction::up ? elevatorState::up : elevatorState::down;
+    int sign = dir == direction::up ? 1 : -1;
+    int numElevators = cars.size();
+    int i = 0;
+
+#ifdef DISPATCHCOST_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i floorLanes = _mm_set1_epi32(floor);
+    const __m128i headingLanes = _mm_set1_epi32(int(heading));
+    const __m128i idleLanes = _mm_set1_epi32(int(elevatorState::idle));
+    const __m128i lookLanes = _mm_set1_epi32(int(queueOrdering::look));
+    const __m128i stopLanes = _mm_set1_epi32(stopCost);
+    const __m128i unavailableLanes = _mm_set1_epi32(unavailable);
+    for (; i + 4 <= numElevators; i += 4)
+    {
+        __m128i car = _mm_loadu_si128(reinterpret_cast<const __m128i *>(floors + i));
+        __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i *>(destinations + i));
+        __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i *>(states + i));
+        __m128i ordering = _mm_loadu_si128(reinterpret_cast<const __m128i *>(orderings + i));
+        __m128i queued = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stops + i));
+        __m128i load = _mm_loadu_si128(reinterpret_cast<const __m128i *>(loads + i));
+        __m128i capacity = _mm_loadu_si128(reinterpret_cast<const __m128i *>(capacities + i));
+
+        // stop counts and the stop cost both fit in the low 16 bits, so madd multiplies them
+        __m128i stopTime = _mm_madd_epi16(queued, stopLanes);
+        __m128i distance = absolute(_mm_sub_epi32(car, floorLanes));
+        __m128i ahead = sign > 0 ? _mm_sub_epi32(floorLanes, car) : _mm_sub_epi32(car, floorLanes);
+        __m128i passing = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(state, headingLanes), _mm_cmpeq_epi32(ordering, lookLanes)), _mm_cmpgt_epi32(ahead, zero));
+
+        __m128i passCost = _mm_add_epi32(distance, stopTime);
+        __m128i tripCost = _mm_add_epi32(_mm_add_epi32(absolute(_mm_sub_epi32(car, destination)), absolute(_mm_sub_epi32(destination, floorLanes))), _mm_add_epi32(stopTime, stopLanes));
+        __m128i cost = select(_mm_cmpeq_epi32(state, idleLanes), distance, select(passing, passCost, tripCost));
+        __m128i full = _mm_andnot_si128(_mm_cmpgt_epi32(capacity, load), _mm_cmpgt_epi32(capacity, zero));
+        cost = select(full, unavailableLanes, cost);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(costs + i), cost);
+    }
+#endif
+
+    for (; i < numElevators; i++)
+    {
+        costs[i] = carCost(floors[i], destinations[i], states[i], orderings[i], stops[i], loads[i], capacities[i], floor, heading, sign, stopCost);
+    }
+}
+
+void DispatchCost::evaluate(const CarStateTable &cars, const int *floors, const direction *dirs, int calls, int *costs) const
+{
+    // the car columns stay in cache from one call to the next
+    for (int call = 0; call < calls; call++)
+    {
+        evaluate(cars, floors[call], dirs[call], costs + call * cars.size());
+    }
+}
+
+int DispatchCost::best(const CarStateTable &cars, int floor, direction dir, int *costs) const
+{
+    evaluate(cars, floor, dir, costs);
+
+    int bestElevator = -1;
+    for (int i = 0; i < cars.size(); i++)
+    {
+        if (costs[i] < unavailable && (bestElevator == -1 || costs[i] < costs[bestElevator - 1]))
+        {
+            bestElevator = i + 1;
+        }
+    }
+    return bestElevator;
+}
@@ -0,0 +1,48 @@
+#ifndef DISPATCHCOST_H
+#define DISPATCHCOST_H
+
+#include "enums.h"
+#include "CarStateTable.h"
+
+// cost of sending each car to a hall call, in floors of travel, worked out for the whole fleet at once.
+// an idle car costs its distance to the call, a look car already heading to the call in the call's direction
+// costs its distance plus its queued stops, any other car first finishes its trip and its stops.
+// every stop counts as stopCost floors, the time a door cycle takes compared to moving one floor.
+// a full car cannot take the call at all and costs unavailable.
+// the car columns are processed four at a time with sse2 where the compiler targets it, otherwise one by one.
+class DispatchCost
+{
+private:
+    int stopCost;
+
+public:
+    // far above any real cost, with room to add stops without overflowing
+    static const int unavailable = 1 << 28;
+
+    DispatchCost(int stopCost = 3);
+
+    int getStopCost() const { return stopCost; }
+
+    // costs[i] is the cost of car i + 1
+    void evaluate(const CarStateTable &cars, int floor, direction dir, int *costs) const;
+
+    // one row of cars.size() costs per call, row after row
+    void evaluate(const CarStateTable &cars, const int *floors, const direction *dirs, int calls, int *costs) const;
+
+    // cheapest car for the call, the lowest number on a tie, or -1 if no car can take it. costs is scratch space for every car
+    int best(const CarStateTable &cars, int floor, direction dir, int *costs) const;
+
+    static bool isVectorised();
+};
+
+#endif // DISPATCHCOST_H
+
+// get uml format for this class like this:
+
+// -stopCost: int
+
+// +getStopCost(): int
+// +evaluate(CarStateTable, int, direction, int *)
+// +evaluate(CarStateTable, int *, direction *, int, int *)
+// +best(CarStateTable, int, direction, int *): int
+// +isVectorised(): bool
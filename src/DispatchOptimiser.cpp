@@ -0,0 +1,122 @@
+#include "DispatchOptimiser.h"
+#include <algorithm>
+
+int DispatchOptimiser::marginalCost(int call, int car, int numElevators) const
+{
+    // the call's own cost plus one stop for every other call the car already has
+    return costs[call * numElevators + car] + planned[car] * cost.getStopCost();
+}
+
+void DispatchOptimiser::plan(const CarStateTable &cars, const QVector<int> &floors, const QVector<direction> &dirs, const QVector<int> &current, QVector<int> &chosen)
+{
+    int calls = floors.size();
+    int numElevators = cars.size();
+    chosen.fill(0, calls);
+    if (calls == 0 || numElevators == 0)
+    {
+        return;
+    }
+
+    costs.resize(calls * numElevators);
+    cost.evaluate(cars, floors.constData(), dirs.constData(), calls, costs.data());
+
+    // calls a car already holds are counted in its queued stops, take them out again
+    // so they are only counted once the plan gives them back to the car
+    held.fill(0, numElevators);
+    for (int i = 0; i < calls; i++)
+    {
+        if (current[i] > 0)
+        {
+            held[current[i] - 1]++;
+        }
+    }
+    for (int car = 0; car < numElevators; car++)
+    {
+        if (held[car] == 0 || cars.state(car + 1) == elevatorState::idle || cars.isFull(car + 1))
+        {
+            continue;
+        }
+        for (int i = 0; i < calls; i++)
+        {
+            int &carCost = costs[i * numElevators + car];
+            carCost = std::max(0, carCost - held[car] * cost.getStopCost());
+        }
+    }
+
+    // greedy: settle the cheapest remaining call and car pair, a tie keeps the call where it is
+    planned.fill(0, numElevators);
+    for (int settled = 0; settled < calls; settled++)
+    {
+        int bestCall = -1;
+        int bestCar = -1;
+        int bestCost = 0;
+        for (int i = 0; i < calls; i++)
+        {
+            if (chosen[i] != 0)
+            {
+                continue;
+            }
+            for (int car = 0; car < numElevators; car++)
+            {
+                int carCost = marginalCost(i, car, numElevators);
+                if (bestCall == -1 || carCost < bestCost || (carCost == bestCost && current[i] == car + 1))
+                {
+                    bestCall = i;
+                    bestCar = car;
+                    bestCost = carCost;
+                }
+            }
+        }
+        if (bestCost >= DispatchCost::unavailable)
+        {
+            // only full cars are left for the remaining calls, they stay where they are
+            for (int i = 0; i < calls; i++)
+            {
+                if (chosen[i] == 0 && current[i] > 0)
+                {
+                    chosen[i] = current[i];
+                    planned[current[i] - 1]++;
+                }
+            }
+            break;
+        }
+        chosen[bestCall] = bestCar + 1;
+        planned[bestCar]++;
+    }
+
+    // improve: move single calls while that lowers the total, every move lowers it so this ends
+    for (int pass = 0; pass < calls; pass++)
+    {
+        bool moved = false;
+        for (int i = 0; i < calls; i++)
+        {
+            int from = chosen[i] - 1;
+            if (from == -1)
+            {
+                continue;
+            }
+            planned[from]--;
+            int bestCar = from;
+            int bestCost = marginalCost(i, from, numElevators);
+            for (int car = 0; car < numElevators; car++)
+            {
+                int carCost = marginalCost(i, car, numElevators);
+                if (carCost < bestCost)
+                {
+                    bestCar = car;
+                    bestCost = carCost;
+                }
+            }
+            planned[bestCar]++;
+            if (bestCar != from)
+            {
+                chosen[i] = bestCar + 1;
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef DISPATCHOPTIMISER_H
+#define DISPATCHOPTIMISER_H
+
+#include "enums.h"
+#include "CarStateTable.h"
+#include "DispatchCost.h"
+#include <QVector>
+
+// decides which car answers each open hall call, looking at all of them together instead of one at a time.
+// the cheapest call and car pair is settled first and every settled call makes its car one stop dearer,
+// then calls are moved one at a time to whichever car lowers the total cost until no move helps.
+// a call no car can take stays with the car holding it, or keeps waiting.
+class DispatchOptimiser
+{
+private:
+    DispatchCost cost;
+    QVector<int> costs;   // one row of car costs per call
+    QVector<int> planned; // calls given to each car so far
+    QVector<int> held;    // calls each car already has queued
+
+    int marginalCost(int call, int car, int numElevators) const;
+
+public:
+    DispatchOptimiser(int stopCost = 3) : cost(stopCost) {}
+
+    void setStopCost(int stopCost) { cost = DispatchCost(stopCost); }
+
+    // current[i] is the car already holding call i, 0 if the call is still waiting for one.
+    // chosen[i] is set to the car that should answer call i
+    void plan(const CarStateTable &cars, const QVector<int> &floors, const QVector<direction> &dirs, const QVector<int> &current, QVector<int> &chosen);
+};
+
+#endif // DISPATCHOPTIMISER_H
+
+// get uml format for this class like this:
+
+// -cost: DispatchCost
+// -costs: QVector<int>
+// -planned: QVector<int>
+// -held: QVector<int>
+
+// +setStopCost(int)
+// +plan(CarStateTable, QVector<int>, QVector<direction>, QVector<int>, QVector<int>)
+// -marginalCost(int, int, int): int
@@ -0,0 +1,88 @@
+#include "DispatchStrategies.h"
+#include "ElevatorControlSystem.h"
+
+int RandomDispatch::selectElevator(ElevatorControlSystem *ecs, int, direction)
+{
+    // randomly select an elevator that is idle
+    const IdleCarIndex &idleElevators = ecs->getIdleElevators();
+    if (idleElevators.size() == 0)
+    {
+        return -1;
+    }
+    return idleElevators.at(ecs->random(randomStream::dispatch, idleElevators.size()));
+}
+
+int ClosestIdleDispatch::selectElevator(ElevatorControlSystem *ecs, int floor, direction)
+{
+    // find the closest idle elevator to the requested floor
+    return ecs->getIdleElevators().nearest(floor);
+}
+
+int EtaDispatch::selectElevator(ElevatorControlSystem *ecs, int floor, direction)
+{
+    // every elevator is a candidate, including ones that still have stops to make
+    int bestElevator = -1;
+    qint64 bestTime = 0;
+    for (int i = 1; i <= ecs->getNumElevators(); i++)
+    {
+        qint64 time = ecs->getElevator(i)->estimateArrivalTime(floor);
+        if (bestElevator == -1 || time < bestTime)
+        {
+            bestTime = time;
+            bestElevator = i;
+        }
+    }
+    return bestElevator;
+}
+
+int CollectiveDispatch::selectElevator(ElevatorControlSystem *ecs, int floor, direction dir)
+{
+    // closest elevator moving the caller's way that has not passed the floor yet
+    int closestElevator = ecs->findPassingElevator(floor, dir);
+    if (closestElevator != -1)
+    {
+        return closestElevator;
+    }
+
+    // otherwise the closest idle elevator
+    return ecs->getIdleElevators().nearest(floor);
+}
+
+int ZoningDispatch::selectElevator(ElevatorControlSystem *ecs, int floor, direction)
+{
+    // one sector per elevator, or per floor when there are more elevators than floors
+    int numFloors = ecs->getNumFloors();
+    int sectors = qMin(ecs->getNumElevators(), numFloors);
+    int sector = (floor - 1) * sectors / numFloors;
+
+    // closest idle elevator belonging to the floor's sector
+    int closestElevator = ecs->getCarStates().closestIdle(floor, sector + 1, sectors);
+    if (closestElevator != -1)
+    {
+        return closestElevator;
+    }
+
+    // the sector is busy, borrow the closest idle elevator from anywhere
+    return ecs->getIdleElevators().nearest(floor);
+}
+
+int CostDispatch::selectElevator(ElevatorControlSystem *ecs, int floor, direction dir)
+{
+    const CarStateTable &cars = ecs->getCarStates();
+    if (cars.size() == 0)
+    {
+        return -1;
+    }
+
+    // a stop costs as many floors as the door cycle takes to move, rounded
+    ElevatorCar *elevator = ecs->getElevator(1);
+    int moveTime = qMax(1, elevator->getFloorTime());
+    DispatchCost cost((elevator->getDoorInterval() + moveTime / 2) / moveTime);
+
+    // the scratch row only grows, so steady state dispatch does not allocate
+    if (costs.size() < cars.size())
+    {
+        costs.resize(cars.size());
+    }
+    return cost.best(cars, floor, dir, costs.data());
+}
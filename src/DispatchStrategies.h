@@ -0,0 +1,71 @@
+#ifndef DISPATCHSTRATEGIES_H
+#define DISPATCHSTRATEGIES_H
+
+#include "DispatchStrategy.h"
+#include "DispatchCost.h"
+
+// sends a random idle elevator
+class RandomDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "random"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+
+    bool looksAtMovingCars() const override { return false; }
+};
+
+// sends the closest idle elevator
+class ClosestIdleDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "closest"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+
+    bool looksAtMovingCars() const override { return false; }
+};
+
+// sends whichever elevator, busy or not, is expected to open its door at the floor first
+class EtaDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "eta"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+};
+
+// directional collective control: the closest elevator already heading the caller's way
+// and not yet past the floor picks the call up, otherwise the closest idle elevator
+class CollectiveDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "collective"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+};
+
+// splits the building into one sector per elevator, calls go to the sector's own elevator when it is idle
+class ZoningDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "zoning"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+
+    bool looksAtMovingCars() const override { return false; }
+};
+
+// sends the car with the lowest dispatch cost, busy or not, scoring the whole fleet in one pass
+class CostDispatch : public DispatchStrategy
+{
+private:
+    QVector<int> costs;
+
+public:
+    QString name() const override { return "cost"; }
+
+    int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) override;
+};
+
+#endif // DISPATCHSTRATEGIES_H
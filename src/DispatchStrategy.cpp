@@ -0,0 +1,56 @@
+#include "DispatchStrategy.h"
+#include "DispatchStrategies.h"
+
+DispatchStrategyRegistry::DispatchStrategyRegistry()
+{
+    // built in strategies, the first one is the default
+    add("closest", []() { return new ClosestIdleDispatch(); });
+    add("random", []() { return new RandomDispatch(); });
+    add("eta", []() { return new EtaDispatch(); });
+    add("collective", []() { return new CollectiveDispatch(); });
+    add("zoning", []() { return new ZoningDispatch(); });
+    add("cost", []() { return new CostDispatch(); });
+}
+
+DispatchStrategyRegistry &DispatchStrategyRegistry::instance()
+{
+    static DispatchStrategyRegistry registry;
+    return registry;
+}
+
+void DispatchStrategyRegistry::add(const QString &name, Factory factory)
+{
+    // registering a name again replaces the old factory
+    for (int i = 0; i < factories.size(); i++)
+    {
+        if (factories[i].first == name)
+        {
+            factories[i].second = factory;
+            return;
+        }
+    }
+    factories.push_back(qMakePair(name, factory));
+}
+
+DispatchStrategy *DispatchStrategyRegistry::create(const QString &name) const
+{
+    // nullptr if no strategy has that name
+    for (int i = 0; i < factories.size(); i++)
+    {
+        if (factories[i].first == name)
+        {
+            return factories[i].second();
+        }
+    }
+    return nullptr;
+}
+
+QStringList DispatchStrategyRegistry::names() const
+{
+    QStringList list;
+    for (int i = 0; i < factories.size(); i++)
+    {
+        list << factories[i].first;
+    }
+    return list;
+}
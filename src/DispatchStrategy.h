@@ -0,0 +1,61 @@
+#ifndef DISPATCHSTRATEGY_H
+#define DISPATCHSTRATEGY_H
+
+#include "enums.h"
+#include <functional>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class ElevatorControlSystem;
+
+// decides which elevator answers a hall call
+class DispatchStrategy
+{
+public:
+    virtual ~DispatchStrategy() {}
+
+    virtual QString name() const = 0;
+
+    // elevator number to send to the floor, or -1 to keep the call pending until an elevator becomes idle
+    virtual int selectElevator(ElevatorControlSystem *ecs, int floor, direction dir) = 0;
+
+    // whether the strategy reads where moving cars are, strategies that only pick idle cars say no
+    virtual bool looksAtMovingCars() const { return true; }
+};
+
+// named dispatch strategies that can be created at runtime, the built in ones are registered up front
+class DispatchStrategyRegistry
+{
+public:
+    typedef std::function<DispatchStrategy *()> Factory;
+
+    static DispatchStrategyRegistry &instance();
+
+    void add(const QString &name, Factory factory);
+
+    DispatchStrategy *create(const QString &name) const;
+
+    QStringList names() const;
+
+private:
+    QVector<QPair<QString, Factory>> factories;
+
+    DispatchStrategyRegistry();
+};
+
+#endif // DISPATCHSTRATEGY_H
+
+// get uml format for this class like this:
+
+// +name(): QString
+// +selectElevator(ElevatorControlSystem *, int, direction): int
+// +looksAtMovingCars(): bool
+
+// -factories: QVector<QPair<QString, Factory>>
+
+// +instance(): DispatchStrategyRegistry
+// +add(QString, Factory)
+// +create(QString): DispatchStrategy *
+// +names(): QStringList
@@ -1,27 +1,98 @@
 #include "ElevatorCar.h"
 #include "ElevatorControlSystem.h"
+#include "TraceRecorder.h"
+#include <climits>
 
-ElevatorCar::ElevatorCar(int number, int currentFloorPosition, ElevatorControlSystem *ecs) : elevatorNumber(number), ecs(ecs), currentFloorPosition(currentFloorPosition), elevatorStatus(elevatorState::idle)
+ElevatorCar::ElevatorCar(int number, int startFloor, ElevatorControlSystem *ecs, queueOrdering ordering) : elevatorNumber(number), currentFloorPosition(ecs->getCarStates().floor(number)), elevatorStatus(ecs->getCarStates().state(number)), destinationFloor(ecs->getCarStates().destination(number)), doorState(ecs->getCarStates().door(number)), floorQueue(ecs->getNumFloors(), ordering), queuedStops(ecs->getCarStates().queuedStops(number)), travelDirection(ecs->getCarStates().travelDirection(number)), passengerLoad(ecs->getCarStates().load(number)), passengerCapacity(ecs->getCarStates().capacity(number)), ecs(ecs)
 {
+    // fill in this car's row of the car table
+    currentFloorPosition = startFloor;
+    elevatorStatus = elevatorState::idle;
+    travelDirection = direction::up;
+    ecs->getCarStates().ordering(number) = ordering;
+
     // set door open
     doorState = doorStatus::close;
+    destinationFloor = currentFloorPosition;
     overload = false;
     doorBlocked = false;
 
+    // empty, with room for anyone, and a fixed dwell until riders are counted
+    passengerLoad = 0;
+    passengerCapacity = 0;
+    doorInterval = 10000;
+    passengerInterval = 0;
+    doorOpenedAt = 0;
+    doorPassengers = 0;
+
+    // one floor per move tick until given a motion profile
+    tripFrom = currentFloorPosition;
+    tripStart = 0;
+    stopFloor = currentFloorPosition;
+    arrivalAt = 0;
+
     // initialize the help timer
-    helpTimer = new QTimer(this);
+    helpTimer = new SimulationTimer(ecs->getScheduler(), this);
     helpTimer->setInterval(2000);
     connect(helpTimer, SIGNAL(timeout()), this, SLOT(handleHelpTimer()));
 
     // initialize the door timer
-    doorTimer = new QTimer(this);
-    doorTimer->setInterval(10000);
+    doorTimer = new SimulationTimer(ecs->getScheduler(), this);
+    doorTimer->setInterval(doorInterval);
     connect(doorTimer, SIGNAL(timeout()), this, SLOT(closeDoor()));
 
     // initialize the move timer
-    moveTimer = new QTimer(this);
+    moveTimer = new SimulationTimer(ecs->getScheduler(), this);
     moveTimer->setInterval(3000);
     connect(moveTimer, SIGNAL(timeout()), this, SLOT(moveToFloor()));
+
+    // initialize the arrival timer, used instead of the move timer with a motion profile
+    arrivalTimer = new SimulationTimer(ecs->getScheduler(), this);
+    connect(arrivalTimer, SIGNAL(timeout()), this, SLOT(arrive()));
+}
+
+void ElevatorCar::setState(elevatorState state)
+{
+    if (elevatorStatus == state)
+    {
+        return;
+    }
+    elevatorStatus = state;
+
+    // keep the control system's idle elevator index up to date
+    ecs->reportStateChanged(elevatorNumber, state);
+}
+
+void ElevatorCar::setDoorInterval(int msec)
+{
+    doorInterval = msec;
+    doorTimer->setInterval(msec);
+}
+
+int ElevatorCar::getFreeSpace()
+{
+    // riders that can still get on
+    if (passengerCapacity <= 0)
+    {
+        return INT_MAX;
+    }
+    return qMax(0, passengerCapacity - passengerLoad);
+}
+
+void ElevatorCar::exchangePassengers(int alighting, int boarding)
+{
+    passengerLoad = qMax(0, passengerLoad - alighting) + boarding;
+
+    // every rider getting on or off keeps the door open a little longer, counted from when it opened
+    doorPassengers += alighting + boarding;
+    if (passengerInterval <= 0 || alighting + boarding == 0 || !doorTimer->isActive())
+    {
+        return;
+    }
+    qint64 closeAt = doorOpenedAt + doorInterval + qint64(passengerInterval) * doorPassengers;
+    doorTimer->stop();
+    doorTimer->setInterval(int(qMax<qint64>(1, closeAt - ecs->now())));
+    doorTimer->start();
 }
 
 void ElevatorCar::setOverload(bool overload)
@@ -66,7 +137,11 @@ void ElevatorCar::stop()
     }
     else
     {
-        elevatorStatus = elevatorState::idle;
+        // a flying car stops where it has got to, and is indexed as idle there
+        updatePosition();
+        arrivalTimer->stop();
+        ecs->reportFlight(elevatorNumber, false);
+        setState(elevatorState::idle);
     }
 }
 
@@ -76,11 +151,13 @@ void ElevatorCar::move(int floor)
     // figure out the direction
     if (floor > currentFloorPosition)
     {
-        elevatorStatus = elevatorState::up;
+        setState(elevatorState::up);
+        travelDirection = direction::up;
     }
     else if (floor < currentFloorPosition)
     {
-        elevatorStatus = elevatorState::down;
+        setState(elevatorState::down);
+        travelDirection = direction::down;
     }
     else
     {
@@ -91,33 +168,210 @@ void ElevatorCar::move(int floor)
     // set the destination floor
     destinationFloor = floor;
 
+    // with a motion profile the whole trip is planned up front and the car wakes up where it stops
+    if (motion.isValid())
+    {
+        tripFrom = currentFloorPosition;
+        tripStart = ecs->now();
+        stopFloor = floor;
+        planFlight();
+        return;
+    }
+
     // timer to move floor by floor
     moveTimer->start();
 }
 
+int ElevatorCar::getFloorTime()
+{
+    // milliseconds to pass one floor at full speed
+    if (motion.isValid())
+    {
+        return qMax(1, qRound(motion.getFloorHeight() / motion.getSpeed() * 1000));
+    }
+    return moveTimer->getInterval();
+}
+
+int ElevatorCar::nextStop(int from)
+{
+    // the first queued floor, or hall call going our way while there is room, from the floor on
+    // towards the destination, like checkStopOnTheWay. the destination if there is none
+    if (floorQueue.getOrdering() != queueOrdering::look)
+    {
+        return destinationFloor;
+    }
+    bool up = travelDirection == direction::up;
+    const FloorBitset &queued = floorQueue.floors();
+    int floor = up ? queued.nextAtOrAbove(from) : queued.nextAtOrBelow(from);
+    if (!isFull())
+    {
+        const FloorBitset &calls = ecs->getFloorRequests().calls(travelDirection);
+        int call = up ? calls.nextAtOrAbove(from) : calls.nextAtOrBelow(from);
+        if (call != -1 && (floor == -1 || (up ? call < floor : call > floor)))
+        {
+            floor = call;
+        }
+    }
+    if (floor == -1 || (up ? floor >= destinationFloor : floor <= destinationFloor))
+    {
+        return destinationFloor;
+    }
+    return floor;
+}
+
+void ElevatorCar::planFlight()
+{
+    // stop at the closest floor ahead that needs a stop and that the car can still switch to.
+    // two trips from standing follow the same curve until the shorter one stops speeding up as hard,
+    // so the stop can only move while the car is still on both curves
+    qint64 elapsed = ecs->now() - tripStart;
+    if (elapsed <= motion.switchPoint(abs(stopFloor - tripFrom)))
+    {
+        // switch points grow with the trip, so the nearest floor still in reach is found by halving
+        int nearest = 1;
+        int farthest = abs(stopFloor - tripFrom);
+        while (nearest < farthest)
+        {
+            int middle = (nearest + farthest) / 2;
+            if (elapsed <= motion.switchPoint(middle))
+            {
+                farthest = middle;
+            }
+            else
+            {
+                nearest = middle + 1;
+            }
+        }
+        int step = destinationFloor > tripFrom ? 1 : -1;
+        stopFloor = nextStop(tripFrom + step * nearest);
+    }
+
+    // leave the timer alone if the stop did not change, rescheduling would only add events
+    qint64 arrivalTime = tripStart + motion.flightTime(abs(stopFloor - tripFrom));
+    if (arrivalTimer->isActive() && arrivalTime == arrivalAt)
+    {
+        return;
+    }
+    arrivalAt = arrivalTime;
+    arrivalTimer->stop();
+    arrivalTimer->setInterval(int(qMax<qint64>(0, arrivalTime - ecs->now())));
+    arrivalTimer->start();
+    ecs->reportFlight(elevatorNumber, true);
+}
+
+void ElevatorCar::updatePosition()
+{
+    // the floor a flying car has got to, only worked out when someone needs it
+    if (!motion.isValid() || !arrivalTimer->isActive())
+    {
+        return;
+    }
+    int step = stopFloor > tripFrom ? 1 : -1;
+    currentFloorPosition = tripFrom + step * motion.floorsCovered(abs(stopFloor - tripFrom), ecs->now() - tripStart);
+}
+
+void ElevatorCar::stopsChanged(int floor)
+{
+    // a new or dropped stop on the rest of the way may move where a flying car stops
+    if (!motion.isValid() || !arrivalTimer->isActive())
+    {
+        return;
+    }
+    bool ahead = travelDirection == direction::up ? floor > tripFrom && floor < destinationFloor : floor < tripFrom && floor > destinationFloor;
+    if (ahead)
+    {
+        planFlight();
+    }
+}
+
+void ElevatorCar::arrive()
+{
+    arrivalTimer->stop();
+    ecs->reportFlight(elevatorNumber, false);
+    currentFloorPosition = stopFloor;
+
+    // a stop on the way ends the trip here, unless the reason for it went away while braking
+    if (currentFloorPosition != destinationFloor)
+    {
+        checkStopOnTheWay();
+    }
+    if (currentFloorPosition != destinationFloor)
+    {
+        tripFrom = currentFloorPosition;
+        tripStart = ecs->now();
+        stopFloor = destinationFloor;
+        planFlight();
+        return;
+    }
+
+    setState(elevatorState::idle);
+    ecs->inform(eventType::reachedDestination, elevatorNumber, currentFloorPosition);
+    openDoor();
+}
+
 void ElevatorCar::moveToFloor()
 {
 
     if (currentFloorPosition == destinationFloor)
     {
         moveTimer->stop();
-        elevatorStatus = elevatorState::idle;
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Reached Destination Floor " + QString::number(currentFloorPosition), elevatorNumber);
+        setState(elevatorState::idle);
+        ecs->inform(eventType::reachedDestination, elevatorNumber, currentFloorPosition);
         openDoor();
         return;
     }
     else if (elevatorStatus == elevatorState::up)
     {
         currentFloorPosition++;
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Moved Up To Floor " + QString::number(currentFloorPosition), elevatorNumber);
+        ecs->inform(eventType::movedUp, elevatorNumber, currentFloorPosition);
+        checkStopOnTheWay();
     }
     else if (elevatorStatus == elevatorState::down)
     {
         currentFloorPosition--;
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Moved Down To Floor " + QString::number(currentFloorPosition), elevatorNumber);
+        ecs->inform(eventType::movedDown, elevatorNumber, currentFloorPosition);
+        checkStopOnTheWay();
     }
 }
 
+void ElevatorCar::checkStopOnTheWay()
+{
+    // only look ordering may serve stops before the current destination
+    if (floorQueue.getOrdering() != queueOrdering::look || currentFloorPosition == destinationFloor)
+    {
+        return;
+    }
+
+    // stop for a queued floor or a waiting hall call going our way.
+    // a full car leaves waiting hall calls for another car
+    bool queued = floorQueue.remove(currentFloorPosition);
+    bool called = !isFull() && ecs->claimFloorRequest(currentFloorPosition, travelDirection);
+    if (queued || called)
+    {
+        // end this trip here and keep the old destination for later
+        floorQueue.add(destinationFloor);
+        queuedStops = floorQueue.size();
+        destinationFloor = currentFloorPosition;
+        ecs->inform(eventType::stoppingOnTheWay, elevatorNumber, currentFloorPosition);
+    }
+}
+
+void ElevatorCar::addFloorToQueue(int floor)
+{
+    floorQueue.add(floor);
+    queuedStops = floorQueue.size();
+    stopsChanged(floor);
+}
+
+bool ElevatorCar::removeFloorFromQueue(int floor)
+{
+    // the current destination is not in the queue and stays
+    bool removed = floorQueue.remove(floor);
+    queuedStops = floorQueue.size();
+    stopsChanged(floor);
+    return removed;
+}
+
 void ElevatorCar::moveToSafeFloor()
 {
     // if doors are open do nothing
@@ -136,61 +390,93 @@ void ElevatorCar::moveToSafeFloor()
     }
     else
     {
+        updatePosition();
+        arrivalTimer->stop();
+        ecs->reportFlight(elevatorNumber, false);
         moveTimer->stop();
         if (currentFloorPosition == 1)
         {
-            elevatorStatus = elevatorState::idle;
-            ecs->inform("Elevator " + QString::number(elevatorNumber) + ": At Emergency Exit Floor " + QString::number(currentFloorPosition), elevatorNumber);
+            setState(elevatorState::idle);
+            ecs->inform(eventType::atEmergencyExit, elevatorNumber, currentFloorPosition);
             openDoor();
             return;
         }
         currentFloorPosition--;
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Moved Down Emergency Exit To Floor " + QString::number(currentFloorPosition), elevatorNumber);
+        ecs->inform(eventType::movedDownEmergencyExit, elevatorNumber, currentFloorPosition);
     }
 }
 
-void ElevatorCar::sortFloorQueue()
+qint64 ElevatorCar::estimateArrivalTime(int floor)
 {
-    int first = floorQueue.at(0);
-    int min, max;
-    if (currentFloorPosition <= first)
+    // rough milliseconds until the car could open its door at the floor, if the floor were added to its queue
+    qint64 moveTime = moveTimer->getInterval();
+    qint64 doorTime = doorInterval;
+    auto travel = [&](int floors) { return motion.isValid() ? motion.flightTime(floors) : floors * moveTime; };
+    qint64 time = 0;
+    int position = currentFloorPosition;
+    bool moving = elevatorStatus == elevatorState::up || elevatorStatus == elevatorState::down;
+
+    if (!moving && doorState == doorStatus::close)
     {
-        min = currentFloorPosition;
-        max = first;
+        return travel(abs(floor - position));
     }
-    else
+    if (!moving)
     {
-        min = first;
-        max = currentFloorPosition;
+        // the door is open, assume it stays open for a full cycle
+        time += doorTime;
     }
-    QVector<int> firstHalf, secondHalf;
-    for (int i = 0; i < floorQueue.size(); i++)
+
+    // fifo ordering finishes the current trip and every queued stop first
+    const FloorBitset &stops = floorQueue.floors();
+    if (floorQueue.getOrdering() == queueOrdering::fifo)
     {
-        int num = floorQueue[i];
-        if (num >= min && num <= max)
+        if (moving)
         {
-            firstHalf.push_back(num);
+            time += travel(abs(destinationFloor - position)) + doorTime;
+            position = destinationFloor;
         }
-        else
+        return time + travel(abs(floor - position) + stops.count()) + stops.count() * doorTime;
+    }
+
+    // look ordering stops at everything ahead, including the current destination, then turns around
+    auto stopsBetween = [&](int low, int high) {
+        int count = stops.countBetween(low, high);
+        if (moving && destinationFloor >= low && destinationFloor <= high && !stops.test(destinationFloor))
         {
-            secondHalf.push_back(num);
+            count++;
         }
+        return count;
+    };
+    bool up = travelDirection == direction::up;
+
+    // a moving car has already passed the floor it is on
+    bool ahead = up ? floor > position || (!moving && floor == position) : floor < position || (!moving && floor == position);
+    if (ahead)
+    {
+        int stopsBefore = up ? stopsBetween(position + 1, floor - 1) : stopsBetween(floor + 1, position - 1);
+        return time + travel(abs(floor - position)) + stopsBefore * doorTime;
     }
 
-    if (currentFloorPosition <= first)
+    // the turning point is the farthest stop ahead
+    int turn = position;
+    int farthest = up ? stops.nextAtOrBelow(stops.size()) : stops.nextAtOrAbove(0);
+    if (farthest != -1 && (up ? farthest > turn : farthest < turn))
     {
-        sort(firstHalf.begin(), firstHalf.end());
+        turn = farthest;
     }
-    else
+    if (moving && (up ? destinationFloor > turn : destinationFloor < turn))
     {
-        sort(firstHalf.begin(), firstHalf.end(), greater<int>());
+        turn = destinationFloor;
     }
-    // concatenate the two vectors
-    floorQueue = firstHalf + secondHalf;
+    int stopsAhead = up ? stopsBetween(position + 1, turn) : stopsBetween(turn, position - 1);
+    int stopsBehind = up ? stopsBetween(floor + 1, position) : stopsBetween(position, floor - 1);
+    return time + travel(abs(turn - position)) + travel(abs(turn - floor)) + (stopsAhead + stopsBehind) * doorTime;
 }
 
 void ElevatorCar::openDoor()
 {
+    TRACE_SCOPE("openDoor");
+
     // cancel any existing timer
     if (doorTimer->isActive())
     {
@@ -198,16 +484,24 @@ void ElevatorCar::openDoor()
     }
 
     // open the door
-    ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Bell Ringed, Door Opened.", elevatorNumber);
+    ecs->inform(eventType::doorOpened, elevatorNumber, currentFloorPosition);
     doorState = doorStatus::open;
-    elevatorStatus = elevatorState::occupied;
+    setState(elevatorState::occupied);
 
-    // start a new timer
+    // start a new timer, riders getting on and off lengthen it
+    doorOpenedAt = ecs->now();
+    doorPassengers = 0;
+    doorTimer->setInterval(doorInterval);
     doorTimer->start();
+
+    // let waiting passengers know the door is open
+    ecs->reportDoorOpened(elevatorNumber, currentFloorPosition);
 }
 
 void ElevatorCar::closeDoor()
 {
+    TRACE_SCOPE("closeDoor");
+
     // cancel any existing timer
     if (doorTimer->isActive())
     {
@@ -217,30 +511,27 @@ void ElevatorCar::closeDoor()
     // check for obstruction and overload
     if (doorBlocked)
     {
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": door blocked. Cannot close.", elevatorNumber);
+        ecs->inform(eventType::doorBlocked, elevatorNumber, currentFloorPosition);
         openDoor();
         return;
     }
     else if (overload)
     {
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Passenger Overload. Cannot close.", elevatorNumber);
+        ecs->inform(eventType::overloaded, elevatorNumber, currentFloorPosition);
         openDoor();
         return;
     }
 
     // close the door
-    ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Bell Ringed, Door Closed.", elevatorNumber);
+    ecs->inform(eventType::doorClosed, elevatorNumber, currentFloorPosition);
     doorState = doorStatus::close;
 
     // check if there are any more floors to visit
-    if (floorQueue.size() > 0)
+    if (!floorQueue.isEmpty())
     {
-        if (allocationStrategy == 1)
-        {
-            sortFloorQueue();
-        }
-        move(floorQueue[0]);
-        floorQueue.remove(0);
+        int floor = floorQueue.take(currentFloorPosition, travelDirection);
+        queuedStops = floorQueue.size();
+        move(floor);
     }
     else
     {
@@ -256,7 +547,7 @@ void ElevatorCar::openDoorRequest()
     // is door timer running?
     if (doorTimer->isActive())
     {
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + " Door Opened by Passengers Request.", elevatorNumber);
+        ecs->inform(eventType::doorOpenedByRequest, elevatorNumber, currentFloorPosition);
         openDoor();
         return;
     }
@@ -270,18 +561,18 @@ void ElevatorCar::closeDoorRequest()
         // check for obstruction and overload
         if (doorBlocked)
         {
-            ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Door Blocked. Can Not close.", elevatorNumber);
+            ecs->inform(eventType::doorBlockedOnRequest, elevatorNumber, currentFloorPosition);
             openDoor();
             return;
         }
         else if (overload)
         {
-            ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Overloaded. Can Not close.", elevatorNumber);
+            ecs->inform(eventType::overloadedOnRequest, elevatorNumber, currentFloorPosition);
             openDoor();
             return;
         }
 
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Door Closed By Passengers Request.", elevatorNumber);
+        ecs->inform(eventType::doorClosedByRequest, elevatorNumber, currentFloorPosition);
         closeDoor();
         return;
     }
@@ -300,7 +591,7 @@ void ElevatorCar::helpRequest()
     stop();
 
     // inform the elevator control system and log the help request
-    ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Help Button Pressed. Ringing For Help. Elevator Stopped.", elevatorNumber);
+    ecs->inform(eventType::helpPressed, elevatorNumber, currentFloorPosition);
 
     helpTimer->start();
 }
@@ -312,15 +603,15 @@ void ElevatorCar::handleHelpTimer()
     helpTimer->stop();
 
     // simulate trying to call building maintenance
-    if (rand() % 2 == 0)
+    if (ecs->random(randomStream::maintenance, 2) == 0)
     {
         // call building maintenance
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Connected To Building Maintenance.", elevatorNumber);
+        ecs->inform(eventType::connectedToMaintenance, elevatorNumber, currentFloorPosition);
     }
     else
     {
         // building maintenance is busy
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Building Maintenance Was Busy. Instead Established Connection With 911.", elevatorNumber);
+        ecs->inform(eventType::connectedTo911, elevatorNumber, currentFloorPosition);
     }
 }
 
@@ -333,17 +624,17 @@ void ElevatorCar::emergency(emergencyType type)
         // disable the door timer
         doorTimer->stop();
         // instruct the passenger to exit the elevator
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + " audio/visual message playing: Please exit the elevator there is an emergency.", elevatorNumber);
+        ecs->inform(eventType::emergencyExitMessage, elevatorNumber, currentFloorPosition);
         return;
     }
 
     if (type == emergencyType::fire)
     {
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Fire Emergency. Moving To Nearest Floor.", elevatorNumber);
+        ecs->inform(eventType::fireEmergency, elevatorNumber, currentFloorPosition);
     }
     else if (type == emergencyType::powerOutage)
     {
-        ecs->inform("Elevator " + QString::number(elevatorNumber) + ": Power Outage Emergency. Moving To Nearest Floor.", elevatorNumber);
+        ecs->inform(eventType::powerOutageEmergency, elevatorNumber, currentFloorPosition);
     }
 
     // move to nearest floor
@@ -356,5 +647,5 @@ void ElevatorCar::emergency(emergencyType type)
     doorTimer->stop();
 
     // message the passengers to exit the elevator
-    ecs->inform("Elevator " + QString::number(elevatorNumber) + " audio/visual message playing: Please exit the elevator there is an emergency.", elevatorNumber);
+    ecs->inform(eventType::emergencyExitMessage, elevatorNumber, currentFloorPosition);
 }
@@ -2,9 +2,11 @@
 #define ELEVATORCAR_H
 
 #include "enums.h"
+#include "SimulationTimer.h"
+#include "DestinationQueue.h"
+#include "MotionProfile.h"
 #include <algorithm>
 #include <QObject>
-#include <QTimer>
 #include <QDebug>
 #include <QVector>
 
@@ -16,38 +18,111 @@ class ElevatorCar : public QObject
 private:
     int elevatorNumber;
 
-    int currentFloorPosition;
-    elevatorState elevatorStatus;
-    int destinationFloor;
+    // hot state lives in the control system's car table, these refer to this car's row
+    int &currentFloorPosition;
+    elevatorState &elevatorStatus;
+    int &destinationFloor;
 
     bool overload;
     bool doorBlocked;
-    doorStatus doorState;
-
-    QVector<int> floorQueue;
+    doorStatus &doorState;
+
+    DestinationQueue floorQueue;
+    int &queuedStops;
+    direction &travelDirection;
+
+    // riders on board and how many fit, 0 for no limit
+    int &passengerLoad;
+    int &passengerCapacity;
+
+    // the door stays open doorInterval plus passengerInterval for every rider getting on or off
+    int doorInterval;
+    int passengerInterval;
+    qint64 doorOpenedAt;
+    int doorPassengers;
+
+    // with a valid motion profile a trip is one flight from tripFrom, timed from tripStart,
+    // that ends at stopFloor instead of one moveTimer tick per floor
+    MotionProfile motion;
+    int tripFrom;
+    qint64 tripStart;
+    int stopFloor;
+    qint64 arrivalAt;
 
     ElevatorControlSystem *ecs;
-    int allocationStrategy = 1; // 0 = queue, 1 = direction based
-    QTimer *helpTimer;
-    QTimer *doorTimer;
-    QTimer *moveTimer;
+    SimulationTimer *helpTimer;
+    SimulationTimer *doorTimer;
+    SimulationTimer *moveTimer;
+    SimulationTimer *arrivalTimer;
 
-    void sortFloorQueue();
+    void setState(elevatorState state);
+    void checkStopOnTheWay();
     void openDoor();
+    void planFlight();
+    int nextStop(int from);
 
 private slots:
     void handleHelpTimer();
     void closeDoor();
     void moveToFloor();
+    void arrive();
 
 public:
-    ElevatorCar(int number, int currentFloorPosition, ElevatorControlSystem *ecs);
+    ElevatorCar(int number, int startFloor, ElevatorControlSystem *ecs, queueOrdering ordering = queueOrdering::look);
 
     elevatorState getState() { return elevatorStatus; }
 
     int getCurrentFloor() { return currentFloorPosition; }
 
-    void addFloorToQueue(int floor) { floorQueue.push_back(floor); }
+    doorStatus getDoorState() { return doorState; }
+
+    int getDestinationFloor() { return destinationFloor; }
+
+    direction getTravelDirection() { return travelDirection; }
+
+    int getQueueSize() { return floorQueue.size(); }
+
+    const DestinationQueue &getQueue() { return floorQueue; }
+
+    int getMoveInterval() { return moveTimer->getInterval(); }
+
+    int getDoorInterval() { return doorInterval; }
+
+    int getPassengerInterval() { return passengerInterval; }
+
+    void setMoveInterval(int msec) { moveTimer->setInterval(msec); }
+
+    void setDoorInterval(int msec);
+
+    void setPassengerInterval(int msec) { passengerInterval = msec; }
+
+    const MotionProfile &getMotionProfile() { return motion; }
+
+    void setMotionProfile(const MotionProfile &profile) { motion = profile; }
+
+    int getFloorTime();
+
+    void updatePosition();
+
+    void stopsChanged(int floor);
+
+    int getLoad() { return passengerLoad; }
+
+    int getCapacity() { return passengerCapacity; }
+
+    void setCapacity(int capacity) { passengerCapacity = capacity; }
+
+    bool isFull() { return passengerCapacity > 0 && passengerLoad >= passengerCapacity; }
+
+    int getFreeSpace();
+
+    void exchangePassengers(int alighting, int boarding);
+
+    qint64 estimateArrivalTime(int floor);
+
+    void addFloorToQueue(int floor);
+
+    bool removeFloorFromQueue(int floor);
 
     void setOverload(bool overload);
 
@@ -81,12 +156,49 @@ public:
 // -overload: bool
 // -doorBlocked: bool
 // -doorState: doorStatus
-// -floorQueue: QVector<int>
-// -helpTimer: QTimer
-// -doorTimer: QTimer
-// -moveTimer: QTimer
-
+// -floorQueue: DestinationQueue
+// -queuedStops: int
+// -travelDirection: direction
+// -passengerLoad: int
+// -passengerCapacity: int
+// -doorInterval: int
+// -passengerInterval: int
+// -doorOpenedAt: qint64
+// -doorPassengers: int
+// -motion: MotionProfile
+// -tripFrom: int
+// -tripStart: qint64
+// -stopFloor: int
+// -arrivalAt: qint64
+// -helpTimer: SimulationTimer
+// -doorTimer: SimulationTimer
+// -moveTimer: SimulationTimer
+// -arrivalTimer: SimulationTimer
+
+// +getDestinationFloor(): int
+// +getTravelDirection(): direction
+// +getQueueSize(): int
+// +getQueue(): DestinationQueue
+// +getMoveInterval(): int
+// +getDoorInterval(): int
+// +getPassengerInterval(): int
+// +setMoveInterval(int)
+// +setDoorInterval(int)
+// +setPassengerInterval(int)
+// +getMotionProfile(): MotionProfile
+// +setMotionProfile(MotionProfile)
+// +getFloorTime(): int
+// +updatePosition()
+// +stopsChanged(int)
+// +getLoad(): int
+// +getCapacity(): int
+// +setCapacity(int)
+// +isFull(): bool
+// +getFreeSpace(): int
+// +exchangePassengers(int, int)
+// +estimateArrivalTime(int): qint64
 // +addFloorToQueue(int)
+// +removeFloorFromQueue(int): bool
 // +stop()
 // +move(int)
 // +moveToSafeFloor()
@@ -95,8 +207,12 @@ public:
 // +helpRequest()
 // +closeDoorRequest()
 // +openDoorRequest()
-// +sortFloorQueue()
+// -setState(elevatorState)
+// -checkStopOnTheWay()
+// -planFlight()
+// -nextStop(int): int
 // +openDoor()
 // +closeDoor()
 // +handleHelpTimer()
 // +moveToFloor()
+// +arrive()
@@ -1,113 +1,418 @@
 #include "ElevatorControlSystem.h"
+#include "TraceRecorder.h"
 
-ElevatorControlSystem::ElevatorControlSystem(int numElevators, int numFloors) : numElevators(numElevators), numFloors(numFloors){};
+ElevatorControlSystem::ElevatorControlSystem(int numElevators, int numFloors, EventScheduler *scheduler) : carStates(numElevators), numElevators(numElevators), numFloors(numFloors), scheduler(scheduler), metrics(numElevators, numFloors)
+{
+    // wall clock for timestamps when there is no virtual clock
+    clock.start();
+
+    // one hall call per floor and direction
+    floorRequests.resize(numFloors);
+    hallCallCars.fill(0, 2 * numFloors);
+    assignedRiders.resize(numElevators + 1);
+    flyingSlots.fill(-1, numElevators + 1);
+
+    // reassignment is off until an interval is set
+    reassignTimer = new SimulationTimer(scheduler, this);
+    connect(reassignTimer, &SimulationTimer::timeout, this, &ElevatorControlSystem::reassignFloorRequests);
+
+    // closest idle elevator unless told otherwise
+    dispatchStrategy = DispatchStrategyRegistry::instance().create("closest");
+
+    setSeed(1);
+};
+
+qint64 ElevatorControlSystem::now() const
+{
+    // simulation time in milliseconds
+    if (scheduler != nullptr)
+    {
+        return scheduler->now();
+    }
+    return clock.elapsed();
+}
+
+void ElevatorControlSystem::setSeed(quint32 seed)
+{
+    // each stream gets its own sequence from the one seed
+    std::seed_seq dispatchSeed{seed, 0u};
+    dispatchRandom.seed(dispatchSeed);
+    std::seed_seq maintenanceSeed{seed, 1u};
+    maintenanceRandom.seed(maintenanceSeed);
+}
+
+int ElevatorControlSystem::random(randomStream stream, int bound)
+{
+    std::uniform_int_distribution<int> distribution(0, bound - 1);
+    return distribution(stream == randomStream::dispatch ? dispatchRandom : maintenanceRandom);
+}
 
 void ElevatorControlSystem::addElevator(ElevatorCar *elevator)
 {
     elevators.push_back(elevator);
+
+    // new elevators start out idle
+    if (elevator->getState() == elevatorState::idle)
+    {
+        idleElevators.insert(elevators.size(), elevator->getCurrentFloor());
+    }
+    else
+    {
+        metrics.carStateChanged(elevators.size(), elevator->getState(), now());
+    }
+}
+
+void ElevatorControlSystem::setDispatchStrategy(DispatchStrategy *strategy)
+{
+    // the control system owns its strategy
+    if (strategy == nullptr || strategy == dispatchStrategy)
+    {
+        return;
+    }
+    delete dispatchStrategy;
+    dispatchStrategy = strategy;
+    qInfo() << "Allocation strategy:" << dispatchStrategy->name();
 }
 
 void ElevatorControlSystem::floorRequest(int floor, direction dir)
 {
-    if (allocationStrategy == 0)
+    TRACE_SCOPE("floorRequest");
+
+    metrics.hallCallPlaced(floor, dir, now());
+
+    // flying cars only need their floor worked out if the strategy looks at them
+    bool positioned = dispatchStrategy->looksAtMovingCars();
+    if (positioned)
+    {
+        updateCarPositions();
+    }
+    int elevatorId = dispatchStrategy->selectElevator(this, floor, dir);
+
+    // a full car cannot take anyone, even if it is standing at the floor
+    if (elevatorId != -1 && carStates.isFull(elevatorId))
+    {
+        elevatorId = -1;
+    }
+
+    // nobody is free, try a car that is already on its way past the floor in the same direction
+    if (elevatorId == -1)
     {
-        qInfo() << "Allocation strategy: random elevator";
-        // randomly select an elevator that is idle
-        QVector<int> idleElevators;
-        for (int i = 0; i < numElevators; i++)
+        if (!positioned)
         {
-            if (elevators[i]->getState() == elevatorState::idle)
-            {
-                idleElevators.push_back(i);
-            }
+            updateCarPositions();
         }
-        if (idleElevators.size() > 0)
+        elevatorId = findPassingElevator(floor, dir);
+    }
+
+    // a car standing at the floor with its door open just opens it again
+    if (elevatorId != -1 && carStates.floor(elevatorId) == floor && carStates.door(elevatorId) == doorStatus::open)
+    {
+        elevators[elevatorId - 1]->openDoorRequest();
+    }
+    else if (elevatorId != -1)
+    {
+        // send the chosen elevator, a busy one adds the floor to its queue.
+        // a stop added only for this call may be handed to another car later
+        bool stopping = carStates.destination(elevatorId) == floor || elevators[elevatorId - 1]->getQueue().contains(floor);
+        sendElevator(elevatorId, floor);
+        if (!stopping)
         {
-            // send move command to a random idle elevator
-            int randomElevator = idleElevators[rand() % idleElevators.size()];
-            moveElevator(randomElevator + 1, floor);
+            hallCallCar(floor, dir) = elevatorId;
         }
-        else
+    }
+    else
+    {
+        // remember the floor request, pressing a lit button again changes nothing
+        if (floorRequests.add(floor, dir))
         {
-            // make floor request a pair of floor and direction
-            floorRequests.push_back(make_pair(floor, dir));
+            floorRequestsChanged(floor, dir);
         }
     }
-    else if (allocationStrategy == 1)
+}
+
+int ElevatorControlSystem::destinationRequest(int floor, int destination)
+{
+    TRACE_SCOPE("destinationRequest");
+
+    // the rider gives their floor at the hall and is told which car to take, so riders going to
+    // the same floors can share a car and it makes fewer stops. the choice is never changed
+    updateCarPositions();
+    if (elevators.isEmpty())
     {
-        qInfo() << "Allocation strategy: closest elevator";
-        // find the closest idle elevator to the requested floor
-        int minDistance = numFloors + 1;
-        int closestElevator = -1;
+        return -1;
+    }
 
-        for (int i = 0; i < numElevators; i++)
+    // the cheapest car with room for everyone already promised to it, or the cheapest car if none has room.
+    // a full car with its door open here cannot take the rider now and would only open again
+    qint64 stopTime = elevators[0]->getDoorInterval() + elevators[0]->getFloorTime();
+    int best = -1;
+    qint64 bestCost = 0;
+    bool bestRoom = false;
+    for (int elevatorId = 1; elevatorId <= numElevators; elevatorId++)
+    {
+        if (carStates.isFull(elevatorId) && carStates.floor(elevatorId) == floor && carStates.door(elevatorId) == doorStatus::open)
         {
-            if (elevators[i]->getState() == elevatorState::idle)
-            {
-                int distance = abs(elevators[i]->getCurrentFloor() - floor);
-                if (distance < minDistance)
-                {
-                    minDistance = distance;
-                    closestElevator = i;
-                }
-            }
+            continue;
         }
-
-        if (closestElevator != -1)
+        int capacity = carStates.capacity(elevatorId);
+        bool room = capacity == 0 || carStates.load(elevatorId) + assignedRiders[elevatorId].size() < capacity;
+        if (bestRoom && !room)
         {
-            // send move command to the closest idle elevator
-            moveElevator(closestElevator + 1, floor);
+            continue;
         }
-        else
+        qint64 cost = destinationCost(elevatorId, floor, destination, stopTime);
+        if (best == -1 || (room && !bestRoom) || cost < bestCost)
         {
-            // make floor request a pair of floor and direction
-            floorRequests.push_back(make_pair(floor, dir));
+            best = elevatorId;
+            bestCost = cost;
+            bestRoom = room;
         }
     }
+
+    if (best == -1)
+    {
+        return -1;
+    }
+
+    // a car standing at the floor with its door open takes the rider straight away
+    if (carStates.floor(best) == floor && carStates.door(best) == doorStatus::open)
+    {
+        return best;
+    }
+    // the call waits from here until this car opens its door at the floor
+    sendElevator(best, floor);
+    if (carStates.floor(best) != floor || carStates.door(best) != doorStatus::open)
+    {
+        metrics.kioskCallPlaced();
+        assignedRiders[best].push_back({floor, destination, now()});
+    }
+    return best;
+}
+
+qint64 ElevatorControlSystem::destinationCost(int elevatorId, int floor, int destination, qint64 stopTime)
+{
+    // time until the car can open its door at the floor, plus a stop for each floor it would not stop at anyway
+    bool open = carStates.floor(elevatorId) == floor && carStates.door(elevatorId) == doorStatus::open;
+    qint64 cost = open ? 0 : elevators[elevatorId - 1]->estimateArrivalTime(floor);
+    const DestinationQueue &queue = elevators[elevatorId - 1]->getQueue();
+    bool moving = carStates.state(elevatorId) == elevatorState::up || carStates.state(elevatorId) == elevatorState::down;
+    if (!open && !queue.contains(floor) && !(moving && carStates.destination(elevatorId) == floor))
+    {
+        cost += stopTime;
+    }
+    bool promised = queue.contains(destination) || (moving && carStates.destination(elevatorId) == destination);
+    for (int i = 0; i < assignedRiders[elevatorId].size() && !promised; i++)
+    {
+        promised = assignedRiders[elevatorId][i].destination == destination;
+    }
+    return promised ? cost : cost + stopTime;
 }
 
 void ElevatorControlSystem::checkFloorRequests(int elevatorId)
 {
+    TRACE_SCOPE("checkFloorRequests");
+
     // if there are no floor requests, return
-    if (floorRequests.size() == 0)
+    if (floorRequests.isEmpty())
     {
         return;
     }
 
     // find the closest floor request to the elevator
-    int minDistance = numFloors + 1;
-    int closestFloorRequest = -1;
+    direction dir;
+    int closestFloorRequest = floorRequests.nearest(carStates.floor(elevatorId), dir);
+
+    if (closestFloorRequest != -1)
+    {
+        // remove the floor request from the queue
+        floorRequests.remove(closestFloorRequest, dir);
+        floorRequestsChanged(closestFloorRequest, dir);
+        // send move command to the closest floor request
+        moveElevator(elevatorId, closestFloorRequest);
+    }
+}
 
-    for (int i = 0; i < floorRequests.size(); i++)
+bool ElevatorControlSystem::claimFloorRequest(int floor, direction dir)
+{
+    // a car passing the floor takes a waiting call going its way
+    if (!floorRequests.remove(floor, dir))
     {
-        int distance = abs(elevators[elevatorId - 1]->getCurrentFloor() - floorRequests[i].first);
-        if (distance < minDistance)
+        return false;
+    }
+    floorRequestsChanged(floor, dir);
+    return true;
+}
+
+void ElevatorControlSystem::floorRequestsChanged(int floor, direction dir)
+{
+    TRACE_COUNTER("hall calls waiting", floorRequests.count());
+
+    // only cars flying the call's way may want to stop for it, or no longer need to
+    const QVector<int> &cars = dir == direction::up ? flyingUp : flyingDown;
+    for (int i = 0; i < cars.size(); i++)
+    {
+        elevators[cars[i] - 1]->stopsChanged(floor);
+    }
+}
+
+void ElevatorControlSystem::updateCarPositions()
+{
+    // cars flying with a motion profile only work out their floor when asked, every other car is where it says
+    for (int i = 0; i < flyingUp.size(); i++)
+    {
+        elevators[flyingUp[i] - 1]->updatePosition();
+    }
+    for (int i = 0; i < flyingDown.size(); i++)
+    {
+        elevators[flyingDown[i] - 1]->updatePosition();
+    }
+}
+
+void ElevatorControlSystem::reportFlight(int elevatorId, bool flying)
+{
+    // swap the last car into a landing car's place, a car never turns round in flight
+    int &slot = flyingSlots[elevatorId];
+    if (flying == (slot != -1))
+    {
+        return;
+    }
+    QVector<int> &cars = carStates.travelDirection(elevatorId) == direction::up ? flyingUp : flyingDown;
+    if (flying)
+    {
+        slot = cars.size();
+        cars.push_back(elevatorId);
+        return;
+    }
+    int last = cars.last();
+    cars[slot] = last;
+    flyingSlots[last] = slot;
+    cars.removeLast();
+    flyingSlots[elevatorId] = -1;
+}
+
+int ElevatorControlSystem::findPassingElevator(int floor, direction dir)
+{
+    // closest car moving towards the floor in the call's direction that can still stop there
+    return carStates.closestHeading(floor, dir);
+}
+
+void ElevatorControlSystem::carRequest(int elevatorNumber, int floor)
+{
+    // a passenger needs the stop now, so a hall call the car holds there can no longer move
+    for (direction dir : {direction::up, direction::down})
+    {
+        if (hallCallCar(floor, dir) == elevatorNumber)
         {
-            minDistance = distance;
-            closestFloorRequest = i;
+            hallCallCar(floor, dir) = 0;
         }
     }
+    sendElevator(elevatorNumber, floor);
+}
 
-    if (closestFloorRequest != -1)
+void ElevatorControlSystem::setReassignInterval(int msec)
+{
+    // 0 keeps every decision as first made
+    if (msec <= 0)
     {
-        // send move command to the closest floor request
-        moveElevator(elevatorId, floorRequests[closestFloorRequest].first);
-        // remove the floor request from the queue
-        floorRequests.erase(floorRequests.begin() + closestFloorRequest);
+        reassignTimer->stop();
+        return;
     }
+    reassignTimer->setInterval(msec);
+    reassignTimer->start();
 }
 
-void ElevatorControlSystem::carRequest(int elevatorNumber, int floor)
+void ElevatorControlSystem::reassignFloorRequests()
 {
-    if (elevators[elevatorNumber - 1]->getState() == elevatorState::idle)
+    TRACE_SCOPE("reassignFloorRequests");
+
+    updateCarPositions();
+
+    // every call still waiting for a car, and every call a car holds only as a queued stop
+    callFloors.clear();
+    callDirs.clear();
+    callCars.clear();
+    for (int floor = 1; floor <= numFloors; floor++)
+    {
+        for (direction dir : {direction::up, direction::down})
+        {
+            int &car = hallCallCar(floor, dir);
+            if (car != 0 && (carStates.destination(car) == floor || !elevators[car - 1]->getQueue().contains(floor)))
+            {
+                // the car is on its way or has dropped the stop, the call is settled
+                car = 0;
+            }
+            if (car != 0 || floorRequests.contains(floor, dir))
+            {
+                callFloors.push_back(floor);
+                callDirs.push_back(dir);
+                callCars.push_back(car);
+            }
+        }
+    }
+    if (callFloors.isEmpty())
+    {
+        return;
+    }
+
+    // a stop costs as many floors as the door cycle takes to move, rounded
+    int moveTime = qMax(1, elevators[0]->getFloorTime());
+    optimiser.setStopCost((elevators[0]->getDoorInterval() + moveTime / 2) / moveTime);
+    optimiser.plan(carStates, callFloors, callDirs, callCars, chosenCars);
+
+    for (int i = 0; i < callFloors.size(); i++)
+    {
+        int floor = callFloors[i];
+        direction dir = callDirs[i];
+        int from = callCars[i];
+        int to = chosenCars[i];
+        if (to == from)
+        {
+            continue;
+        }
+
+        if (from == 0)
+        {
+            floorRequests.remove(floor, dir);
+            floorRequestsChanged(floor, dir);
+        }
+        else
+        {
+            // the old car keeps the stop while it still holds the floor's other call
+            hallCallCar(floor, dir) = 0;
+            direction other = dir == direction::up ? direction::down : direction::up;
+            if (hallCallCar(floor, other) != from)
+            {
+                elevators[from - 1]->removeFloorFromQueue(floor);
+            }
+        }
+
+        // hand the call over the same way a new hall call is sent
+        if (carStates.floor(to) == floor && carStates.door(to) == doorStatus::open)
+        {
+            elevators[to - 1]->openDoorRequest();
+            continue;
+        }
+        bool stopping = carStates.destination(to) == floor || elevators[to - 1]->getQueue().contains(floor);
+        sendElevator(to, floor);
+        if (!stopping)
+        {
+            hallCallCar(floor, dir) = to;
+        }
+    }
+}
+
+void ElevatorControlSystem::sendElevator(int elevatorId, int floor)
+{
+    if (carStates.state(elevatorId) == elevatorState::idle)
     {
         // if the elevator is idle, send move command to the elevator
-        moveElevator(elevatorNumber, floor);
+        moveElevator(elevatorId, floor);
     }
     else
     {
         // if the elevator is not idle, add the request to the queue
-        elevators[elevatorNumber - 1]->addFloorToQueue(floor);
+        elevators[elevatorId - 1]->addFloorToQueue(floor);
+        metrics.stopQueued(elevators[elevatorId - 1]->getQueueSize());
     }
 }
 
@@ -119,8 +424,9 @@ void ElevatorControlSystem::moveElevator(int elevatorId, int floor)
 
 void ElevatorControlSystem::fireAlarm()
 {
-    // emit a signal to log the fire alarm
-    emit log("Fire alarm activated.", -1);
+    // log the fire alarm
+    inform(eventType::fireAlarm, -1, 0);
+    reassignTimer->stop();
 
     for (int i = 0; i < numElevators; i++)
     {
@@ -131,8 +437,9 @@ void ElevatorControlSystem::fireAlarm()
 
 void ElevatorControlSystem::powerOutage()
 {
-    // emit a signal to log the power outage
-    emit log("Power outage detected.", -1);
+    // log the power outage
+    inform(eventType::powerOutage, -1, 0);
+    reassignTimer->stop();
 
     for (int i = 0; i < numElevators; i++)
     {
@@ -141,10 +448,60 @@ void ElevatorControlSystem::powerOutage()
     }
 }
 
-void ElevatorControlSystem::inform(QString q, int elevatorId)
+void ElevatorControlSystem::inform(eventType type, int elevatorId, int floor)
+{
+    TRACE_SCOPE("inform");
+
+    // record the event as is, viewers turn it into text if they want to show it
+    eventLog.record(now(), elevatorId, type, floor);
+    emit eventLogged();
+}
+
+void ElevatorControlSystem::reportDoorOpened(int elevatorId, int floor)
+{
+    // everyone waiting at the floor can get on, so its hall calls are answered
+    for (direction dir : {direction::up, direction::down})
+    {
+        if (floorRequests.remove(floor, dir))
+        {
+            floorRequestsChanged(floor, dir);
+        }
+    }
+    hallCallCar(floor, direction::up) = 0;
+    hallCallCar(floor, direction::down) = 0;
+    metrics.hallCallAnswered(floor, now());
+
+    // riders told to take this car get on here, their kiosk calls are answered only by this car
+    QVector<KioskRider> &riders = assignedRiders[elevatorId];
+    for (int i = riders.size() - 1; i >= 0; i--)
+    {
+        if (riders[i].floor == floor)
+        {
+            metrics.kioskCallAnswered(riders[i].calledAt, now());
+            riders.remove(i);
+        }
+    }
+
+    // emit a signal so passengers at the floor can get on and off
+    emit doorOpened(elevatorId, floor);
+}
+
+void ElevatorControlSystem::reportStateChanged(int elevatorId, elevatorState state)
 {
-    // emit a signal to log the inform
-    emit log(q, elevatorId);
+    metrics.carStateChanged(elevatorId, state, now());
+
+    // idle elevators never move, so their floor only needs recording when they become idle
+    if (state == elevatorState::idle)
+    {
+        idleElevators.insert(elevatorId, carStates.floor(elevatorId));
+    }
+    else
+    {
+        idleElevators.remove(elevatorId);
+    }
 }
 
-ElevatorControlSystem::~ElevatorControlSystem() {}
+ElevatorControlSystem::~ElevatorControlSystem()
+{
+    delete dispatchStrategy;
+}
@@ -6,43 +6,146 @@
 #include <QDebug>
 #include <QObject>
 #include "ElevatorCar.h"
+#include "EventScheduler.h"
+#include "IdleCarIndex.h"
+#include "CarStateTable.h"
+#include "HallCallTable.h"
+#include "DispatchStrategy.h"
+#include "DispatchOptimiser.h"
+#include "SimulationTimer.h"
+#include "SimulationMetrics.h"
+#include "EventLog.h"
+#include <QElapsedTimer>
+#include <random>
 
 using namespace std;
 
+// a rider given a car at a destination kiosk and not yet aboard
+struct KioskRider
+{
+    int floor;
+    int destination;
+    qint64 calledAt; // when the kiosk call was placed
+};
+
 class ElevatorControlSystem : public QObject
 {
     Q_OBJECT
 private:
     // QVector<pair<int, direction>> carRequests;
-    QVector<pair<int, direction>> floorRequests;
+    HallCallTable floorRequests;
     QVector<ElevatorCar *> elevators;
+    CarStateTable carStates;
+    IdleCarIndex idleElevators;
     int numElevators;
     int numFloors;
-    int allocationStrategy = 1; // 0 = random elevator, 1 = closest elevator
+    DispatchStrategy *dispatchStrategy;
+    EventScheduler *scheduler;  // nullptr when running in real time
+    QElapsedTimer clock;
+    SimulationMetrics metrics;
+    EventLog eventLog;
+    std::mt19937 dispatchRandom;
+    std::mt19937 maintenanceRandom;
+
+    // hall calls handed to a car as an extra queued stop, which reassignment may still move to another car
+    QVector<int> hallCallCars; // car holding each floor's up and down call, 0 if none
+
+    // cars flying with a motion profile by direction, and where each one sits in its list, -1 if it is not flying
+    QVector<int> flyingUp;
+    QVector<int> flyingDown;
+    QVector<int> flyingSlots;
+    DispatchOptimiser optimiser;
+    SimulationTimer *reassignTimer;
+    QVector<int> callFloors;
+    QVector<direction> callDirs;
+    QVector<int> callCars;
+    QVector<int> chosenCars;
+
+    // riders given a car at a destination kiosk and not yet aboard, indexed by car
+    QVector<QVector<KioskRider>> assignedRiders;
+
+    int &hallCallCar(int floor, direction dir) { return hallCallCars[2 * (floor - 1) + (dir == direction::up ? 0 : 1)]; }
 
     void moveElevator(int elevatorId, int floor);
 
+    void floorRequestsChanged(int floor, direction dir);
+
+    void sendElevator(int elevatorId, int floor);
+
+    qint64 destinationCost(int elevatorId, int floor, int destination, qint64 stopTime);
+
 signals:
-    void log(QString q, int elevatorId);
+    void eventLogged();
+
+    void doorOpened(int elevatorId, int floor);
 
 public:
-    ElevatorControlSystem(int numElevators, int numFloors);
+    ElevatorControlSystem(int numElevators, int numFloors, EventScheduler *scheduler = nullptr);
 
     ~ElevatorControlSystem();
 
     void addElevator(ElevatorCar *elevator);
 
+    EventScheduler *getScheduler() { return scheduler; }
+
+    int getNumElevators() { return numElevators; }
+
+    int getNumFloors() { return numFloors; }
+
+    ElevatorCar *getElevator(int elevatorId) { return elevators[elevatorId - 1]; }
+
+    CarStateTable &getCarStates() { return carStates; }
+
+    const IdleCarIndex &getIdleElevators() { return idleElevators; }
+
+    const HallCallTable &getFloorRequests() { return floorRequests; }
+
+    void updateCarPositions();
+
+    DispatchStrategy *getDispatchStrategy() { return dispatchStrategy; }
+
+    void setDispatchStrategy(DispatchStrategy *strategy);
+
+    void setReassignInterval(int msec);
+
+    void reassignFloorRequests();
+
+    SimulationMetrics &getMetrics() { return metrics; }
+
+    const EventLog &getEventLog() { return eventLog; }
+
+    qint64 now() const;
+
+    // seeds every random stream, the same seed and commands give the same run
+    void setSeed(quint32 seed);
+
+    // a number from 0 to bound - 1 drawn from one stream
+    int random(randomStream stream, int bound);
+
     void floorRequest(int floor, direction direction);
 
+    int destinationRequest(int floor, int destination);
+
     void checkFloorRequests(int elevatorId);
 
+    bool claimFloorRequest(int floor, direction dir);
+
+    int findPassingElevator(int floor, direction dir);
+
     void carRequest(int elevatorNumber, int floor);
 
     void fireAlarm();
 
     void powerOutage();
 
-    void inform(QString q, int elevatorId);
+    void inform(eventType type, int elevatorId, int floor);
+
+    void reportDoorOpened(int elevatorId, int floor);
+
+    void reportStateChanged(int elevatorId, elevatorState state);
+
+    // a car with a motion profile took off or landed
+    void reportFlight(int elevatorId, bool flying);
 };
 
 #endif // ELEVATORCONTROLSYSTEM_H
@@ -51,14 +154,62 @@ public:
 
 // -numElevators: int
 // -numFloors: int
-// -floorRequests: QVector<pair<int, direction>>
+// -floorRequests: HallCallTable
+// -carStates: CarStateTable
+// -idleElevators: IdleCarIndex
+// -dispatchStrategy: DispatchStrategy *
+// -hallCallCars: QVector<int>
+// -flyingUp: QVector<int>
+// -flyingDown: QVector<int>
+// -flyingSlots: QVector<int>
+// -optimiser: DispatchOptimiser
+// -reassignTimer: SimulationTimer *
+// -callFloors: QVector<int>
+// -callDirs: QVector<direction>
+// -callCars: QVector<int>
+// -chosenCars: QVector<int>
+// -assignedRiders: QVector<QVector<KioskRider>>
+// -scheduler: EventScheduler *
+// -clock: QElapsedTimer
+// -metrics: SimulationMetrics
+// -eventLog: EventLog
+// -dispatchRandom: mt19937
+// -maintenanceRandom: mt19937
 
 // +addElevator(ElevatorCar *)
+// +getScheduler(): EventScheduler *
+// +getNumElevators(): int
+// +getNumFloors(): int
+// +getElevator(int): ElevatorCar *
+// +getCarStates(): CarStateTable
+// +getIdleElevators(): IdleCarIndex
+// +getFloorRequests(): HallCallTable
+// +updateCarPositions()
+// +getDispatchStrategy(): DispatchStrategy *
+// +setDispatchStrategy(DispatchStrategy *)
+// +setReassignInterval(int)
+// +reassignFloorRequests()
+// +getMetrics(): SimulationMetrics
+// +getEventLog(): EventLog
+// +now(): qint64
+// +setSeed(quint32)
+// +random(randomStream, int): int
 // +floorRequest(int, direction)
+// +destinationRequest(int, int): int
 // +checkFloorRequests(int)
+// +claimFloorRequest(int, direction): bool
+// +findPassingElevator(int, direction): int
 // +carRequest(int, int)
 // +fireAlarm()
 // +powerOutage()
-// +inform(QString, int)
-// +log(QString, int)
+// +inform(eventType, int, int)
+// +reportDoorOpened(int, int)
+// +reportStateChanged(int, elevatorState)
+// +reportFlight(int, bool)
+// +eventLogged()
+// +doorOpened(int, int)
+// -hallCallCar(int, direction): int
 // -moveElevator(int, int)
+// -floorRequestsChanged(int, direction)
+// -sendElevator(int, int)
+// -destinationCost(int, int, int, qint64): qint64
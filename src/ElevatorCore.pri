@@ -0,0 +1,62 @@
+# Simulation engine shared by the GUI and the command line targets
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# qmake CONFIG+=tracing compiles in the engine's trace scopes, see TraceRecorder.h
+tracing: DEFINES += ELEVATOR_TRACING
+
+SOURCES += \
+        $$PWD/ElevatorControlSystem.cpp \
+        $$PWD/ElevatorCar.cpp \
+        $$PWD/EventScheduler.cpp \
+        $$PWD/SimulationTimer.cpp \
+        $$PWD/SimulationRunner.cpp \
+        $$PWD/SimulationSweep.cpp \
+        $$PWD/IdleCarIndex.cpp \
+        $$PWD/CarStateTable.cpp \
+        $$PWD/FloorBitset.cpp \
+        $$PWD/BuildingLayout.cpp \
+        $$PWD/HallCallTable.cpp \
+        $$PWD/DestinationQueue.cpp \
+        $$PWD/DispatchStrategy.cpp \
+        $$PWD/DispatchStrategies.cpp \
+        $$PWD/DispatchCost.cpp \
+        $$PWD/DispatchOptimiser.cpp \
+        $$PWD/MotionProfile.cpp \
+        $$PWD/TrafficGenerator.cpp \
+        $$PWD/CallTrace.cpp \
+        $$PWD/Histogram.cpp \
+        $$PWD/SimulationMetrics.cpp \
+        $$PWD/EventLog.cpp \
+        $$PWD/SessionLog.cpp \
+        $$PWD/SimulationEngine.cpp \
+        $$PWD/TraceRecorder.cpp \
+
+HEADERS += \
+        $$PWD/ElevatorControlSystem.h \
+        $$PWD/enums.h \
+        $$PWD/ElevatorCar.h \
+        $$PWD/EventScheduler.h \
+        $$PWD/SimulationTimer.h \
+        $$PWD/SimulationRunner.h \
+        $$PWD/SimulationSweep.h \
+        $$PWD/IdleCarIndex.h \
+        $$PWD/CarStateTable.h \
+        $$PWD/FloorBitset.h \
+        $$PWD/BuildingLayout.h \
+        $$PWD/HallCallTable.h \
+        $$PWD/DestinationQueue.h \
+        $$PWD/DispatchStrategy.h \
+        $$PWD/DispatchStrategies.h \
+        $$PWD/DispatchCost.h \
+        $$PWD/DispatchOptimiser.h \
+        $$PWD/MotionProfile.h \
+        $$PWD/TrafficGenerator.h \
+        $$PWD/CallTrace.h \
+        $$PWD/Histogram.h \
+        $$PWD/SimulationMetrics.h \
+        $$PWD/EventLog.h \
+        $$PWD/SessionLog.h \
+        $$PWD/SimulationEngine.h \
+        $$PWD/TraceRecorder.h \
@@ -24,17 +24,16 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 CONFIG += c++11
 
+include(ElevatorCore.pri)
+
 SOURCES += \
-        ElevatorControlSystem.cpp \
         main.cpp \
         mainwindow.cpp \
-        ElevatorCar.cpp \
+        SystemLogModel.cpp \
 
 HEADERS += \
-        ElevatorControlSystem.h \
         mainwindow.h \
-        enums.h \
-        ElevatorCar.h \
+        SystemLogModel.h \
 
 FORMS += \
         mainwindow.ui
@@ -0,0 +1,67 @@
+#include "EventLog.h"
+
+EventLog::EventLog(int capacity)
+{
+    // round up to a power of two so the ring position is a mask instead of a division
+    quint64 size = 1;
+    while (size < quint64(qMax(capacity, 1)))
+    {
+        size <<= 1;
+    }
+    records.resize(size);
+    mask = size - 1;
+}
+
+QString EventLog::format(const LogEvent &event)
+{
+    QString elevator = "Elevator " + QString::number(event.elevatorId);
+    QString floor = QString::number(event.floor);
+    switch (event.type)
+    {
+    case eventType::reachedDestination:
+        return elevator + ": Reached Destination Floor " + floor;
+    case eventType::movedUp:
+        return elevator + ": Moved Up To Floor " + floor;
+    case eventType::movedDown:
+        return elevator + ": Moved Down To Floor " + floor;
+    case eventType::stoppingOnTheWay:
+        return elevator + ": Stopping On The Way At Floor " + floor;
+    case eventType::atEmergencyExit:
+        return elevator + ": At Emergency Exit Floor " + floor;
+    case eventType::movedDownEmergencyExit:
+        return elevator + ": Moved Down Emergency Exit To Floor " + floor;
+    case eventType::doorOpened:
+        return elevator + ": Bell Ringed, Door Opened.";
+    case eventType::doorBlocked:
+        return elevator + ": door blocked. Cannot close.";
+    case eventType::overloaded:
+        return elevator + ": Passenger Overload. Cannot close.";
+    case eventType::doorClosed:
+        return elevator + ": Bell Ringed, Door Closed.";
+    case eventType::doorOpenedByRequest:
+        return elevator + " Door Opened by Passengers Request.";
+    case eventType::doorBlockedOnRequest:
+        return elevator + ": Door Blocked. Can Not close.";
+    case eventType::overloadedOnRequest:
+        return elevator + ": Overloaded. Can Not close.";
+    case eventType::doorClosedByRequest:
+        return elevator + ": Door Closed By Passengers Request.";
+    case eventType::helpPressed:
+        return elevator + ": Help Button Pressed. Ringing For Help. Elevator Stopped.";
+    case eventType::connectedToMaintenance:
+        return elevator + ": Connected To Building Maintenance.";
+    case eventType::connectedTo911:
+        return elevator + ": Building Maintenance Was Busy. Instead Established Connection With 911.";
+    case eventType::emergencyExitMessage:
+        return elevator + " audio/visual message playing: Please exit the elevator there is an emergency.";
+    case eventType::fireEmergency:
+        return elevator + ": Fire Emergency. Moving To Nearest Floor.";
+    case eventType::powerOutageEmergency:
+        return elevator + ": Power Outage Emergency. Moving To Nearest Floor.";
+    case eventType::fireAlarm:
+        return "Fire alarm activated.";
+    case eventType::powerOutage:
+        return "Power outage detected.";
+    }
+    return QString();
+}
@@ -0,0 +1,93 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include "enums.h"
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+// one thing that happened in the building, 16 bytes with no text attached
+struct LogEvent
+{
+    qint64 time;      // milliseconds on the control system's clock
+    qint32 floor;
+    qint16 elevatorId; // -1 for building wide events
+    eventType type;
+};
+
+// fixed size ring buffer of log events. recording never allocates, once the buffer is full the
+// oldest events are overwritten. events are numbered from 0 in the order they were recorded,
+// and only turned into text when a viewer asks for them.
+// a running hash of every event ever recorded tells two runs apart without keeping them.
+class EventLog
+{
+private:
+    static const quint64 emptyDigest = 14695981039346656037ULL;
+
+    std::vector<LogEvent> records;
+    quint64 mask;
+    quint64 written = 0;
+    quint64 digest = emptyDigest;
+
+    void hash(quint64 value)
+    {
+        // fnv-1a, one whole field at a time
+        digest = (digest ^ value) * 1099511628211ULL;
+    }
+
+public:
+    EventLog(int capacity = 4096);
+
+    void record(qint64 time, int elevatorId, eventType type, int floor)
+    {
+        LogEvent &event = records[written & mask];
+        event.time = time;
+        event.floor = floor;
+        event.elevatorId = qint16(elevatorId);
+        event.type = type;
+        written++;
+        hash(quint64(time));
+        hash(quint64(quint32(floor)) << 16 | quint16(elevatorId));
+        hash(quint64(type));
+    }
+
+    int capacity() const { return int(records.size()); }
+
+    // number of the next event to be recorded
+    quint64 end() const { return written; }
+
+    // number of the oldest event still in the buffer
+    quint64 begin() const { return written > records.size() ? written - records.size() : 0; }
+
+    const LogEvent &at(quint64 number) const { return records[number & mask]; }
+
+    // hash of every event recorded so far, equal logs give equal digests
+    quint64 getDigest() const { return digest; }
+
+    void clear()
+    {
+        written = 0;
+        digest = emptyDigest;
+    }
+
+    static QString format(const LogEvent &event);
+};
+
+#endif // EVENTLOG_H
+
+// get uml format for this class like this:
+
+// -records: vector<LogEvent>
+// -mask: quint64
+// -written: quint64
+// -digest: quint64
+
+// +record(qint64, int, eventType, int)
+// +capacity(): int
+// +end(): quint64
+// +begin(): quint64
+// +at(quint64): LogEvent
+// +getDigest(): quint64
+// +clear()
+// +format(const LogEvent &): QString
+// -hash(quint64)
@@ -0,0 +1,61 @@
+#include "EventScheduler.h"
+#include "TraceRecorder.h"
+
+void EventScheduler::schedule(qint64 delay, std::function<void()> action)
+{
+    // events can never be scheduled in the past
+    scheduleAt(currentTime + qMax<qint64>(delay, 0), std::move(action));
+}
+
+void EventScheduler::scheduleAt(qint64 time, std::function<void()> action)
+{
+    events.push({qMax(time, currentTime), nextSequence++, std::move(action)});
+}
+
+bool EventScheduler::step()
+{
+    if (events.empty())
+    {
+        return false;
+    }
+
+    // move the clock forward to the next event and run it
+    ScheduledEvent event = events.top();
+    events.pop();
+    currentTime = event.time;
+    currentStale = false;
+    {
+        TRACE_SCOPE("event");
+        event.action();
+    }
+    if (currentStale)
+    {
+        staleEvents++;
+    }
+    else
+    {
+        processedEvents++;
+    }
+    return true;
+}
+
+void EventScheduler::runUntil(qint64 endTime)
+{
+    while (!events.empty() && events.top().time <= endTime)
+    {
+        step();
+    }
+
+    // the clock always ends up at the requested time, even if nothing was due
+    if (currentTime < endTime)
+    {
+        currentTime = endTime;
+    }
+}
+
+void EventScheduler::run()
+{
+    while (step())
+    {
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef EVENTSCHEDULER_H
+#define EVENTSCHEDULER_H
+
+#include <functional>
+#include <queue>
+#include <vector>
+#include <QtGlobal>
+
+// virtual clock and queue of timestamped events used to run the simulation headless.
+// nothing here touches wall-clock time, so the simulation runs as fast as the events can be processed.
+class EventScheduler
+{
+private:
+    struct ScheduledEvent
+    {
+        qint64 time;
+        quint64 sequence; // events due at the same time run in the order they were scheduled
+        std::function<void()> action;
+    };
+
+    struct LaterFirst
+    {
+        bool operator()(const ScheduledEvent &a, const ScheduledEvent &b) const
+        {
+            if (a.time != b.time)
+            {
+                return a.time > b.time;
+            }
+            return a.sequence > b.sequence;
+        }
+    };
+
+    qint64 currentTime = 0;
+    quint64 nextSequence = 0;
+    quint64 processedEvents = 0;
+    quint64 staleEvents = 0;
+    bool currentStale = false;
+    std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, LaterFirst> events;
+
+public:
+    EventScheduler() {}
+
+    qint64 now() const { return currentTime; }
+
+    bool isEmpty() const { return events.empty(); }
+
+    int pendingEvents() const { return static_cast<int>(events.size()); }
+
+    // events that did something, stale ones are counted apart
+    quint64 getProcessedEvents() const { return processedEvents; }
+
+    quint64 getStaleEvents() const { return staleEvents; }
+
+    // called from inside an event that turned out to have nothing left to do, like a stopped timer's
+    void discardCurrent() { currentStale = true; }
+
+    void schedule(qint64 delay, std::function<void()> action);
+
+    void scheduleAt(qint64 time, std::function<void()> action);
+
+    bool step();
+
+    void runUntil(qint64 endTime);
+
+    void run();
+};
+
+#endif // EVENTSCHEDULER_H
+
+// get uml format for this class like this:
+
+// -currentTime: qint64
+// -nextSequence: quint64
+// -processedEvents: quint64
+// -staleEvents: quint64
+// -currentStale: bool
+// -events: priority_queue<ScheduledEvent>
+
+// +now(): qint64
+// +isEmpty(): bool
+// +pendingEvents(): int
+// +getProcessedEvents(): quint64
+// +getStaleEvents(): quint64
+// +discardCurrent()
+// +schedule(qint64, function<void()>)
+// +scheduleAt(qint64, function<void()>)
+// +step(): bool
+// +runUntil(qint64)
+// +run()
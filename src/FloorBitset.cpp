@@ -0,0 +1,127 @@
+#include "FloorBitset.h"
+#include <QtAlgorithms>
+
+void FloorBitset::resize(int numFloors)
+{
+    // floors are numbered from 1, bit 0 is never used
+    this->numFloors = numFloors;
+    words.assign((numFloors >> 6) + 1, 0);
+    setCount = 0;
+}
+
+bool FloorBitset::set(int floor)
+{
+    // returns false if the floor was already set
+    if (floor < 0 || floor > numFloors || test(floor))
+    {
+        return false;
+    }
+    words[floor >> 6] |= quint64(1) << (floor & 63);
+    setCount++;
+    return true;
+}
+
+bool FloorBitset::reset(int floor)
+{
+    // returns false if the floor was not set
+    if (!test(floor))
+    {
+        return false;
+    }
+    words[floor >> 6] &= ~(quint64(1) << (floor & 63));
+    setCount--;
+    return true;
+}
+
+void FloorBitset::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+    setCount = 0;
+}
+
+int FloorBitset::nextAtOrAbove(int floor) const
+{
+    // closest set floor at or above the given floor, -1 if there is none
+    if (setCount == 0 || floor > numFloors)
+    {
+        return -1;
+    }
+    floor = qMax(floor, 0);
+
+    int word = floor >> 6;
+    quint64 bits = words[word] & (~quint64(0) << (floor & 63));
+    while (bits == 0)
+    {
+        if (++word >= int(words.size()))
+        {
+            return -1;
+        }
+        bits = words[word];
+    }
+    return (word << 6) + qCountTrailingZeroBits(bits);
+}
+
+int FloorBitset::nextAtOrBelow(int floor) const
+{
+    // closest set floor at or below the given floor, -1 if there is none
+    if (setCount == 0 || floor < 0)
+    {
+        return -1;
+    }
+    floor = qMin(floor, numFloors);
+
+    int word = floor >> 6;
+    quint64 bits = words[word] & (~quint64(0) >> (63 - (floor & 63)));
+    while (bits == 0)
+    {
+        if (--word < 0)
+        {
+            return -1;
+        }
+        bits = words[word];
+    }
+    return (word << 6) + 63 - qCountLeadingZeroBits(bits);
+}
+
+int FloorBitset::nearest(int floor) const
+{
+    // closest set floor in either direction, ties go to the floor below
+    int below = nextAtOrBelow(floor);
+    int above = nextAtOrAbove(floor);
+    if (below == -1)
+    {
+        return above;
+    }
+    if (above == -1)
+    {
+        return below;
+    }
+    return above - floor < floor - below ? above : below;
+}
+
+int FloorBitset::countBetween(int low, int high) const
+{
+    // number of set floors from low to high, both included
+    low = qMax(low, 0);
+    high = qMin(high, numFloors);
+    if (setCount == 0 || low > high)
+    {
+        return 0;
+    }
+
+    int lowWord = low >> 6;
+    int highWord = high >> 6;
+    quint64 lowMask = ~quint64(0) << (low & 63);
+    quint64 highMask = ~quint64(0) >> (63 - (high & 63));
+    if (lowWord == highWord)
+    {
+        return qPopulationCount(words[lowWord] & lowMask & highMask);
+    }
+
+    int total = qPopulationCount(words[lowWord] & lowMask) + qPopulationCount(words[highWord] & highMask);
+    for (int word = lowWord + 1; word < highWord; word++)
+    {
+        total += qPopulationCount(words[word]);
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+#ifndef FLOORBITSET_H
+#define FLOORBITSET_H
+
+#include <QtGlobal>
+#include <vector>
+
+// one bit per floor with fast searches for the closest set floor above or below a position.
+// searches skip 64 floors at a time, so they stay cheap even for very tall buildings.
+class FloorBitset
+{
+private:
+    std::vector<quint64> words;
+    int numFloors = 0;
+    int setCount = 0;
+
+public:
+    FloorBitset() {}
+
+    FloorBitset(int numFloors) { resize(numFloors); }
+
+    void resize(int numFloors);
+
+    int size() const { return numFloors; }
+
+    int count() const { return setCount; }
+
+    bool isEmpty() const { return setCount == 0; }
+
+    bool test(int floor) const
+    {
+        return floor >= 0 && floor <= numFloors && (words[floor >> 6] >> (floor & 63)) & 1;
+    }
+
+    bool set(int floor);
+
+    bool reset(int floor);
+
+    void clear();
+
+    int nextAtOrAbove(int floor) const;
+
+    int nextAtOrBelow(int floor) const;
+
+    int nearest(int floor) const;
+
+    int countBetween(int low, int high) const;
+};
+
+#endif // FLOORBITSET_H
+
+// get uml format for this class like this:
+
+// -words: vector<quint64>
+// -numFloors: int
+// -setCount: int
+
+// +resize(int)
+// +size(): int
+// +count(): int
+// +isEmpty(): bool
+// +test(int): bool
+// +set(int): bool
+// +reset(int): bool
+// +clear()
+// +nextAtOrAbove(int): int
+// +nextAtOrBelow(int): int
+// +nearest(int): int
+// +countBetween(int, int): int
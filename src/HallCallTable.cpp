@@ -0,0 +1,41 @@
+#include "HallCallTable.h"
+#include <cstdlib>
+
+void HallCallTable::resize(int numFloors)
+{
+    upCalls.resize(numFloors);
+    downCalls.resize(numFloors);
+}
+
+bool HallCallTable::add(int floor, direction dir)
+{
+    // returns false if the call was already pending
+    return dir == direction::up ? upCalls.set(floor) : downCalls.set(floor);
+}
+
+bool HallCallTable::remove(int floor, direction dir)
+{
+    return dir == direction::up ? upCalls.reset(floor) : downCalls.reset(floor);
+}
+
+bool HallCallTable::contains(int floor, direction dir) const
+{
+    return dir == direction::up ? upCalls.test(floor) : downCalls.test(floor);
+}
+
+int HallCallTable::nearest(int floor, direction &dir) const
+{
+    // closest pending call to the floor, -1 if there is none.
+    // on equal distance the lower floor wins, then the up call
+    int up = upCalls.nearest(floor);
+    int down = downCalls.nearest(floor);
+    int upDistance = abs(up - floor);
+    int downDistance = abs(down - floor);
+    if (down == -1 || (up != -1 && (upDistance < downDistance || (upDistance == downDistance && up <= down))))
+    {
+        dir = direction::up;
+        return up;
+    }
+    dir = direction::down;
+    return down;
+}
@@ -0,0 +1,51 @@
+#ifndef HALLCALLTABLE_H
+#define HALLCALLTABLE_H
+
+#include "enums.h"
+#include "FloorBitset.h"
+
+// pending hall calls, at most one per floor and direction.
+// repeated presses of a lit button are ignored and the closest call is found without scanning every call.
+class HallCallTable
+{
+private:
+    FloorBitset upCalls;
+    FloorBitset downCalls;
+
+public:
+    HallCallTable() {}
+
+    HallCallTable(int numFloors) { resize(numFloors); }
+
+    void resize(int numFloors);
+
+    bool add(int floor, direction dir);
+
+    bool remove(int floor, direction dir);
+
+    bool contains(int floor, direction dir) const;
+
+    int count() const { return upCalls.count() + downCalls.count(); }
+
+    bool isEmpty() const { return count() == 0; }
+
+    int nearest(int floor, direction &dir) const;
+
+    const FloorBitset &calls(direction dir) const { return dir == direction::up ? upCalls : downCalls; }
+};
+
+#endif // HALLCALLTABLE_H
+
+// get uml format for this class like this:
+
+// -upCalls: FloorBitset
+// -downCalls: FloorBitset
+
+// +resize(int)
+// +add(int, direction): bool
+// +remove(int, direction): bool
+// +contains(int, direction): bool
+// +count(): int
+// +isEmpty(): bool
+// +nearest(int, direction &): int
+// +calls(direction): FloorBitset
@@ -0,0 +1,97 @@
+#include "Histogram.h"
+#include <QtAlgorithms>
+
+int Histogram::bucketIndex(qint64 value)
+{
+    // small values are counted exactly
+    if (value < 2 * subBucketCount)
+    {
+        return int(value);
+    }
+
+    // keep the top bits of larger values, the shift says which power of two they fall in
+    int highestBit = 63 - int(qCountLeadingZeroBits(quint64(value)));
+    int shift = highestBit - subBucketBits;
+    return shift * subBucketCount + int(value >> shift);
+}
+
+qint64 Histogram::bucketHighest(int index)
+{
+    // largest value that lands in the bucket
+    if (index < 2 * subBucketCount)
+    {
+        return index;
+    }
+    int shift = index / subBucketCount - 1;
+    qint64 mantissa = index - shift * subBucketCount;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void Histogram::record(qint64 value)
+{
+    value = qMax(value, qint64(0));
+    int index = bucketIndex(value);
+    if (index >= int(buckets.size()))
+    {
+        buckets.resize(index + 1, 0);
+    }
+    buckets[index]++;
+
+    minimum = total == 0 ? value : qMin(minimum, value);
+    maximum = total == 0 ? value : qMax(maximum, value);
+    sum += value;
+    total++;
+}
+
+void Histogram::merge(const Histogram &other)
+{
+    if (other.total == 0)
+    {
+        return;
+    }
+    if (other.buckets.size() > buckets.size())
+    {
+        buckets.resize(other.buckets.size(), 0);
+    }
+    for (size_t i = 0; i < other.buckets.size(); i++)
+    {
+        buckets[i] += other.buckets[i];
+    }
+
+    minimum = total == 0 ? other.minimum : qMin(minimum, other.minimum);
+    maximum = total == 0 ? other.maximum : qMax(maximum, other.maximum);
+    sum += other.sum;
+    total += other.total;
+}
+
+void Histogram::clear()
+{
+    buckets.clear();
+    total = 0;
+    sum = 0;
+    minimum = 0;
+    maximum = 0;
+}
+
+qint64 Histogram::percentile(double percent) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // walk the buckets until the requested share of values has been passed
+    quint64 rank = quint64(qBound(0.0, percent, 100.0) / 100.0 * total + 0.5);
+    rank = qBound(quint64(1), rank, total);
+    quint64 seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // never report more than was actually recorded
+            return qBound(minimum, bucketHighest(int(i)), maximum);
+        }
+    }
+    return maximum;
+}
@@ -0,0 +1,66 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QtGlobal>
+#include <vector>
+
+// streaming histogram of non-negative values with percentiles accurate to about 3%.
+// values below 64 get a bucket each, above that every power of two is split into 32 buckets,
+// so memory stays small no matter how many values are recorded or how large they get.
+class Histogram
+{
+private:
+    static const int subBucketBits = 5;
+    static const int subBucketCount = 1 << subBucketBits;
+
+    std::vector<quint64> buckets;
+    quint64 total = 0;
+    double sum = 0;
+    qint64 minimum = 0;
+    qint64 maximum = 0;
+
+    static int bucketIndex(qint64 value);
+
+    static qint64 bucketHighest(int index);
+
+public:
+    void record(qint64 value);
+
+    void merge(const Histogram &other);
+
+    void clear();
+
+    quint64 count() const { return total; }
+
+    bool isEmpty() const { return total == 0; }
+
+    double mean() const { return total > 0 ? sum / total : 0; }
+
+    qint64 min() const { return minimum; }
+
+    qint64 max() const { return maximum; }
+
+    qint64 percentile(double percent) const;
+};
+
+#endif // HISTOGRAM_H
+
+// get uml format for this class like this:
+
+// -buckets: vector<quint64>
+// -total: quint64
+// -sum: double
+// -minimum: qint64
+// -maximum: qint64
+
+// +record(qint64)
+// +merge(const Histogram &)
+// +clear()
+// +count(): quint64
+// +isEmpty(): bool
+// +mean(): double
+// +min(): qint64
+// +max(): qint64
+// +percentile(double): qint64
+// -bucketIndex(qint64): int
+// -bucketHighest(int): qint64
@@ -0,0 +1,83 @@
+#include "IdleCarIndex.h"
+#include <iterator>
+
+void IdleCarIndex::insert(int elevatorId, int floor)
+{
+    // grow the lookup tables to fit the elevator number
+    if (elevatorId >= position.size())
+    {
+        int oldSize = position.size();
+        position.resize(elevatorId + 1);
+        floorOf.resize(elevatorId + 1);
+        for (int i = oldSize; i < position.size(); i++)
+        {
+            position[i] = -1;
+        }
+    }
+
+    // an elevator that is already idle might have been indexed at another floor
+    if (contains(elevatorId))
+    {
+        remove(elevatorId);
+    }
+
+    byFloor.insert(std::make_pair(floor, elevatorId));
+    position[elevatorId] = idleCars.size();
+    floorOf[elevatorId] = floor;
+    idleCars.push_back(elevatorId);
+}
+
+void IdleCarIndex::remove(int elevatorId)
+{
+    if (!contains(elevatorId))
+    {
+        return;
+    }
+
+    byFloor.erase(std::make_pair(floorOf[elevatorId], elevatorId));
+
+    // swap the last idle elevator into the free spot
+    int freed = position[elevatorId];
+    int last = idleCars.last();
+    idleCars[freed] = last;
+    position[last] = freed;
+    idleCars.removeLast();
+    position[elevatorId] = -1;
+}
+
+int IdleCarIndex::nearest(int floor) const
+{
+    if (byFloor.empty())
+    {
+        return -1;
+    }
+
+    // lowest numbered elevator at or above the floor
+    auto above = byFloor.lower_bound(std::make_pair(floor, 0));
+
+    // lowest numbered elevator on the closest floor below
+    auto below = byFloor.end();
+    if (above != byFloor.begin())
+    {
+        auto previous = std::prev(above);
+        below = byFloor.lower_bound(std::make_pair(previous->first, 0));
+    }
+
+    if (above == byFloor.end())
+    {
+        return below->second;
+    }
+    if (below == byFloor.end())
+    {
+        return above->second;
+    }
+
+    // ties go to the lower numbered elevator, same as scanning the elevators in order
+    int aboveDistance = above->first - floor;
+    int belowDistance = floor - below->first;
+    if (aboveDistance != belowDistance)
+    {
+        return aboveDistance < belowDistance ? above->second : below->second;
+    }
+    return qMin(above->second, below->second);
+}
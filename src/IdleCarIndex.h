@@ -0,0 +1,46 @@
+#ifndef IDLECARINDEX_H
+#define IDLECARINDEX_H
+
+#include <QVector>
+#include <set>
+#include <utility>
+
+// idle elevators ordered by floor, kept up to date as elevators change state.
+// finding the idle elevator closest to a floor is O(log n) instead of a scan over every elevator.
+class IdleCarIndex
+{
+private:
+    std::set<std::pair<int, int>> byFloor; // (floor, elevator number)
+    QVector<int> idleCars;                 // dense list of idle elevator numbers for random picks
+    QVector<int> position;                 // where each elevator sits in idleCars, -1 when busy
+    QVector<int> floorOf;                  // floor each idle elevator was indexed at
+
+public:
+    void insert(int elevatorId, int floor);
+
+    void remove(int elevatorId);
+
+    bool contains(int elevatorId) const { return elevatorId < position.size() && position[elevatorId] != -1; }
+
+    int size() const { return idleCars.size(); }
+
+    int at(int i) const { return idleCars[i]; }
+
+    int nearest(int floor) const;
+};
+
+#endif // IDLECARINDEX_H
+
+// get uml format for this class like this:
+
+// -byFloor: set<pair<int, int>>
+// -idleCars: QVector<int>
+// -position: QVector<int>
+// -floorOf: QVector<int>
+
+// +insert(int, int)
+// +remove(int)
+// +contains(int): bool
+// +size(): int
+// +at(int): int
+// +nearest(int): int
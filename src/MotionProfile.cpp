@@ -0,0 +1,130 @@
+#include "MotionProfile.h"
+#include <algorithm>
+#include <cmath>
+
+MotionProfile::MotionProfile(double speed, double acceleration, double jerk, double floorHeight) : speed(speed), acceleration(acceleration), jerk(jerk), floorHeight(floorHeight)
+{
+}
+
+double MotionProfile::rampTime(double topSpeed) const
+{
+    // seconds to go from standing to topSpeed, acceleration peaks below the rated value on short ramps
+    double peakAcceleration = std::min(acceleration, std::sqrt(topSpeed * jerk));
+    return topSpeed / peakAcceleration + peakAcceleration / jerk;
+}
+
+double MotionProfile::rampDistance(double topSpeed, double time) const
+{
+    // metres covered time seconds into a ramp from standing to topSpeed
+    double peakAcceleration = std::min(acceleration, std::sqrt(topSpeed * jerk));
+    double jerkTime = peakAcceleration / jerk;
+    double totalTime = rampTime(topSpeed);
+    if (time <= jerkTime)
+    {
+        return jerk * time * time * time / 6;
+    }
+    if (time <= totalTime - jerkTime)
+    {
+        double jerkSpeed = jerk * jerkTime * jerkTime / 2;
+        double jerkDistance = jerk * jerkTime * jerkTime * jerkTime / 6;
+        double held = time - jerkTime;
+        return jerkDistance + jerkSpeed * held + peakAcceleration * held * held / 2;
+    }
+
+    // the end of the ramp mirrors its start, and the whole ramp covers half of topSpeed times its length
+    double left = totalTime - time;
+    return topSpeed * totalTime / 2 - (topSpeed * left - jerk * left * left * left / 6);
+}
+
+double MotionProfile::peakSpeed(double distance) const
+{
+    // rated speed if speeding up and slowing down fit in the distance
+    if (distance >= speed * rampTime(speed))
+    {
+        return speed;
+    }
+
+    // otherwise the top speed whose two ramps cover exactly the distance
+    double fullAccelerationSpeed = acceleration * acceleration / jerk;
+    if (distance >= fullAccelerationSpeed * rampTime(fullAccelerationSpeed))
+    {
+        double jerkTime = acceleration / jerk;
+        return acceleration / 2 * (-jerkTime + std::sqrt(jerkTime * jerkTime + 4 * distance / acceleration));
+    }
+    return std::pow(distance * std::sqrt(jerk) / 2, 2.0 / 3.0);
+}
+
+qint64 MotionProfile::flightTime(int floors) const
+{
+    if (floors <= 0 || !isValid())
+    {
+        return 0;
+    }
+    double distance = floors * floorHeight;
+    double topSpeed = peakSpeed(distance);
+    double ramp = rampTime(topSpeed);
+    double cruise = (distance - topSpeed * ramp) / topSpeed;
+    return qRound64((2 * ramp + std::max(0.0, cruise)) * 1000);
+}
+
+qint64 MotionProfile::brakingPoint(int floors) const
+{
+    if (floors <= 0 || !isValid())
+    {
+        return 0;
+    }
+    double topSpeed = peakSpeed(floors * floorHeight);
+    return flightTime(floors) - qRound64(rampTime(topSpeed) * 1000);
+}
+
+qint64 MotionProfile::switchPoint(int floors) const
+{
+    if (floors <= 0 || !isValid())
+    {
+        return 0;
+    }
+
+    // a trip that reaches rated speed only leaves a longer trip's curve when it starts braking.
+    // a shorter one leaves it as soon as its acceleration stops rising or starts to ease off,
+    // while the longer trip keeps accelerating
+    double topSpeed = peakSpeed(floors * floorHeight);
+    if (topSpeed >= speed)
+    {
+        return brakingPoint(floors);
+    }
+    double peakAcceleration = std::min(acceleration, std::sqrt(topSpeed * jerk));
+    return qRound64(topSpeed / peakAcceleration * 1000);
+}
+
+int MotionProfile::floorsCovered(int floors, qint64 elapsed) const
+{
+    qint64 total = flightTime(floors);
+    if (elapsed <= 0 || total == 0)
+    {
+        return 0;
+    }
+    if (elapsed >= total)
+    {
+        return floors;
+    }
+
+    double distance = floors * floorHeight;
+    double topSpeed = peakSpeed(distance);
+    double ramp = rampTime(topSpeed);
+    double time = elapsed / 1000.0;
+    double totalTime = total / 1000.0;
+    double covered;
+    if (time < ramp)
+    {
+        covered = rampDistance(topSpeed, time);
+    }
+    else if (time <= totalTime - ramp)
+    {
+        covered = topSpeed * ramp / 2 + topSpeed * (time - ramp);
+    }
+    else
+    {
+        covered = distance - rampDistance(topSpeed, totalTime - time);
+    }
+    return std::min(floors, int(covered / floorHeight + 1e-9));
+}
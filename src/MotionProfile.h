@@ -0,0 +1,69 @@
+#ifndef MOTIONPROFILE_H
+#define MOTIONPROFILE_H
+
+#include <QtGlobal>
+
+// how long a car takes to travel between floors, worked out in closed form instead of tick by tick.
+// a trip follows a jerk limited s-curve: acceleration ramps up at the rated jerk, holds at the rated
+// acceleration, ramps down as the car reaches rated speed, cruises, then mirrors all of that to stop.
+// short trips never reach rated speed, very short ones never reach rated acceleration either.
+// a profile with no speed is not valid and means the car moves one floor per tick instead.
+class MotionProfile
+{
+private:
+    double speed;        // metres per second
+    double acceleration; // metres per second squared
+    double jerk;         // metres per second cubed
+    double floorHeight;  // metres
+
+    double peakSpeed(double distance) const;
+    double rampTime(double topSpeed) const;
+    double rampDistance(double topSpeed, double time) const;
+
+public:
+    MotionProfile(double speed = 0, double acceleration = 1.0, double jerk = 1.5, double floorHeight = 3.5);
+
+    bool isValid() const { return speed > 0 && acceleration > 0 && jerk > 0 && floorHeight > 0; }
+
+    double getSpeed() const { return speed; }
+
+    double getAcceleration() const { return acceleration; }
+
+    double getJerk() const { return jerk; }
+
+    double getFloorHeight() const { return floorHeight; }
+
+    // milliseconds from starting to stopping floors away
+    qint64 flightTime(int floors) const;
+
+    // milliseconds from starting until the car has to start slowing down to stop floors away
+    qint64 brakingPoint(int floors) const;
+
+    // milliseconds a trip of floors follows the same curve as any longer trip, so its stop can still be moved
+    qint64 switchPoint(int floors) const;
+
+    // floors fully passed elapsed milliseconds into a trip of floors
+    int floorsCovered(int floors, qint64 elapsed) const;
+};
+
+#endif // MOTIONPROFILE_H
+
+// get uml format for this class like this:
+
+// -speed: double
+// -acceleration: double
+// -jerk: double
+// -floorHeight: double
+
+// +isValid(): bool
+// +getSpeed(): double
+// +getAcceleration(): double
+// +getJerk(): double
+// +getFloorHeight(): double
+// +flightTime(int): qint64
+// +brakingPoint(int): qint64
+// +switchPoint(int): qint64
+// +floorsCovered(int, qint64): int
+// -peakSpeed(double): double
+// -rampTime(double): double
+// -rampDistance(double, double): double
@@ -0,0 +1,266 @@
+#include "SessionLog.h"
+#include "ElevatorControlSystem.h"
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+namespace
+{
+// command names in the file, in commandType order
+const char *const commandNames[] = {"floor", "car", "help", "open", "close", "block", "overload", "fire", "power"};
+const int commandCount = int(sizeof(commandNames) / sizeof(commandNames[0]));
+
+// what the on column means for each kind of command, empty if it means nothing
+QString onText(const SessionCommand &command)
+{
+    switch (command.type)
+    {
+    case commandType::floorRequest:
+        return command.on ? "up" : "down";
+    case commandType::doorBlocked:
+    case commandType::overload:
+        return command.on ? "on" : "off";
+    default:
+        return QString();
+    }
+}
+}
+
+bool SessionLog::save(const QString &fileName, QString &error) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "# elevator simulator session\n";
+    out << "floors," << config.numFloors << "\n";
+    out << "elevators," << config.numElevators << "\n";
+    out << "seed," << config.seed << "\n";
+    out << "strategy," << config.strategy << "\n";
+    out << "ordering," << (config.ordering == queueOrdering::look ? "look" : "fifo") << "\n";
+    out << "duration," << config.duration << "\n";
+    out << "move_time," << config.moveTime << "\n";
+    out << "door_time," << config.doorTime << "\n";
+    out << "reassign," << config.reassignInterval << "\n";
+    out << "capacity," << config.capacity << "\n";
+    out << "passenger_time," << config.passengerTime << "\n";
+    out << "speed," << config.speed << "\n";
+    out << "acceleration," << config.acceleration << "\n";
+    out << "jerk," << config.jerk << "\n";
+    out << "floor_height," << config.floorHeight << "\n";
+    out << "time,command,elevator,floor,on\n";
+    for (const SessionCommand &command : commands)
+    {
+        out << command.time << "," << commandNames[int(command.type)] << "," << command.elevatorId << "," << command.floor << "," << onText(command) << "\n";
+    }
+
+    out.flush();
+    if (file.error() != QFileDevice::NoError)
+    {
+        error = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SessionLog::load(const QString &fileName, QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = "cannot read " + fileName + ": " + file.errorString();
+        return false;
+    }
+
+    SimulationConfig loaded;
+    QVector<SessionCommand> loadedCommands;
+    bool inCommands = false;
+    int lineNumber = 0;
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#'))
+        {
+            continue;
+        }
+        QStringList fields = line.split(',');
+        QString where = fileName + " line " + QString::number(lineNumber);
+
+        // building settings until the command header
+        if (!inCommands)
+        {
+            if (fields[0] == "time")
+            {
+                inCommands = true;
+                continue;
+            }
+            if (fields.size() != 2)
+            {
+                error = where + ": expected a name and a value.";
+                return false;
+            }
+            QString name = fields[0];
+            QString value = fields[1];
+            bool ok = true;
+            if (name == "floors")
+            {
+                loaded.numFloors = value.toInt(&ok);
+                ok = ok && loaded.numFloors >= 2;
+            }
+            else if (name == "elevators")
+            {
+                loaded.numElevators = value.toInt(&ok);
+                ok = ok && loaded.numElevators >= 1;
+            }
+            else if (name == "seed")
+            {
+                loaded.seed = value.toUInt(&ok);
+            }
+            else if (name == "strategy")
+            {
+                loaded.strategy = value;
+                ok = DispatchStrategyRegistry::instance().names().contains(value);
+            }
+            else if (name == "ordering")
+            {
+                loaded.ordering = value == "fifo" ? queueOrdering::fifo : queueOrdering::look;
+                ok = value == "fifo" || value == "look";
+            }
+            else if (name == "duration")
+            {
+                loaded.duration = value.toLongLong(&ok);
+            }
+            else if (name == "move_time")
+            {
+                loaded.moveTime = value.toInt(&ok);
+            }
+            else if (name == "door_time")
+            {
+                loaded.doorTime = value.toInt(&ok);
+            }
+            else if (name == "reassign")
+            {
+                loaded.reassignInterval = value.toInt(&ok);
+            }
+            else if (name == "capacity")
+            {
+                loaded.capacity = value.toInt(&ok);
+            }
+            else if (name == "passenger_time")
+            {
+                loaded.passengerTime = value.toInt(&ok);
+            }
+            else if (name == "speed")
+            {
+                loaded.speed = value.toDouble(&ok);
+            }
+            else if (name == "acceleration")
+            {
+                loaded.acceleration = value.toDouble(&ok);
+            }
+            else if (name == "jerk")
+            {
+                loaded.jerk = value.toDouble(&ok);
+            }
+            else if (name == "floor_height")
+            {
+                loaded.floorHeight = value.toDouble(&ok);
+            }
+            else
+            {
+                error = where + ": unknown setting " + name + ".";
+                return false;
+            }
+            if (!ok)
+            {
+                error = where + ": bad " + name + " " + value + ".";
+                return false;
+            }
+            continue;
+        }
+
+        // one command per line, in the order they were given
+        if (fields.size() != 5)
+        {
+            error = where + ": expected time, command, elevator, floor and on.";
+            return false;
+        }
+        SessionCommand command;
+        bool ok = true;
+        command.time = fields[0].toLongLong(&ok);
+        int type = 0;
+        while (type < commandCount && fields[1] != commandNames[type])
+        {
+            type++;
+        }
+        command.type = commandType(type);
+        command.elevatorId = ok ? fields[2].toInt(&ok) : 0;
+        command.floor = ok ? fields[3].toInt(&ok) : 0;
+        command.on = fields[4] == "up" || fields[4] == "on";
+        if (!ok || type == commandCount || command.time < 0 || (!loadedCommands.isEmpty() && command.time < loadedCommands.last().time))
+        {
+            error = where + ": bad command.";
+            return false;
+        }
+
+        // commands have to fit the building they are given to
+        bool hallCall = command.type == commandType::floorRequest;
+        bool buildingWide = command.type == commandType::fireAlarm || command.type == commandType::powerOutage;
+        if ((hallCall || buildingWide) != (command.elevatorId == 0) || command.elevatorId < 0 || command.elevatorId > loaded.numElevators
+            || ((hallCall || command.type == commandType::carRequest) && (command.floor < 1 || command.floor > loaded.numFloors)))
+        {
+            error = where + ": command does not fit the building.";
+            return false;
+        }
+        loadedCommands.push_back(command);
+    }
+
+    if (!inCommands)
+    {
+        error = fileName + ": no commands header.";
+        return false;
+    }
+    config = loaded;
+    commands = loadedCommands;
+    return true;
+}
+
+void SessionLog::apply(const SessionCommand &command, ElevatorControlSystem *ecs)
+{
+    switch (command.type)
+    {
+    case commandType::floorRequest:
+        ecs->floorRequest(command.floor, command.on ? direction::up : direction::down);
+        break;
+    case commandType::carRequest:
+        ecs->getElevator(command.elevatorId)->carRequest(command.floor);
+        break;
+    case commandType::helpRequest:
+        ecs->getElevator(command.elevatorId)->helpRequest();
+        break;
+    case commandType::openDoorRequest:
+        ecs->getElevator(command.elevatorId)->openDoorRequest();
+        break;
+    case commandType::closeDoorRequest:
+        ecs->getElevator(command.elevatorId)->closeDoorRequest();
+        break;
+    case commandType::doorBlocked:
+        ecs->getElevator(command.elevatorId)->setDoorBlocked(command.on);
+        break;
+    case commandType::overload:
+        ecs->getElevator(command.elevatorId)->setOverload(command.on);
+        break;
+    case commandType::fireAlarm:
+        ecs->fireAlarm();
+        break;
+    case commandType::powerOutage:
+        ecs->powerOutage();
+        break;
+    }
+}
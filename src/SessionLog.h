@@ -0,0 +1,64 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include "SimulationRunner.h"
+#include "enums.h"
+#include <QString>
+#include <QVector>
+
+class ElevatorControlSystem;
+
+// one command as it was given to the building
+struct SessionCommand
+{
+    qint64 time;      // milliseconds on the control system's clock
+    commandType type;
+    int elevatorId;   // 0 for hall calls and building wide commands
+    int floor;
+    bool on;          // up for hall calls, set for door blocks and overloads
+};
+
+// every input command of a session together with the building it was given to.
+// the building and its seed fix everything random, so playing the commands back at their
+// times on the virtual clock gives the same events every time, see SimulationRunner::replay.
+// saved as text: the building settings as name,value lines, then one line per command.
+class SessionLog
+{
+private:
+    SimulationConfig config;
+    QVector<SessionCommand> commands;
+
+public:
+    SessionLog(const SimulationConfig &config = SimulationConfig()) : config(config) {}
+
+    const SimulationConfig &getConfig() const { return config; }
+
+    // milliseconds the session lasted, a replay runs this long
+    void setDuration(qint64 duration) { config.duration = duration; }
+
+    const QVector<SessionCommand> &getCommands() const { return commands; }
+
+    void record(const SessionCommand &command) { commands.push_back(command); }
+
+    bool save(const QString &fileName, QString &error) const;
+
+    bool load(const QString &fileName, QString &error);
+
+    // give one command to the building, the same way the engine does
+    static void apply(const SessionCommand &command, ElevatorControlSystem *ecs);
+};
+
+#endif // SESSIONLOG_H
+
+// get uml format for this class like this:
+
+// -config: SimulationConfig
+// -commands: QVector<SessionCommand>
+
+// +getConfig(): SimulationConfig
+// +setDuration(qint64)
+// +getCommands(): QVector<SessionCommand>
+// +record(const SessionCommand &)
+// +save(const QString &, QString &): bool
+// +load(const QString &, QString &): bool
+// +apply(const SessionCommand &, ElevatorControlSystem *)
@@ -0,0 +1,214 @@
+#include "SimulationEngine.h"
+#include <QDebug>
+#include <random>
+
+SimulationEngine::SimulationEngine(QObject *parent) : QObject(parent)
+{
+    // the feed crosses threads, so its types have to be known to queued connections
+    qRegisterMetaType<QVector<LogEvent>>("QVector<LogEvent>");
+    qRegisterMetaType<QVector<CarSnapshot>>("QVector<CarSnapshot>");
+
+    // a child timer moves to the engine's thread along with the engine
+    updateTimer = new QTimer(this);
+    updateTimer->setInterval(16);
+    connect(updateTimer, &QTimer::timeout, this, &SimulationEngine::sendUpdate);
+}
+
+void SimulationEngine::post(std::function<void()> command)
+{
+    // run the command from the engine thread's event loop, in the order commands were posted
+    QMetaObject::invokeMethod(this, command, Qt::QueuedConnection);
+}
+
+void SimulationEngine::start(int numElevators, int numFloors, quint32 seed)
+{
+    post([this, numElevators, numFloors, seed]() {
+        shutdown();
+
+        // cars are created here so their timers belong to the engine's thread
+        ecs = new ElevatorControlSystem(numElevators, numFloors);
+        ecs->setSeed(seed);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> floorDistribution(1, numFloors);
+        for (int i = 0; i < numElevators; i++)
+        {
+            // start elevators at seeded random floors, the same way the headless runner does
+            ElevatorCar *elevator = new ElevatorCar(i + 1, floorDistribution(rng), ecs);
+            elevators.push_back(elevator);
+            ecs->addElevator(elevator);
+        }
+
+        // the engine's cars use the default settings, so only the building and seed need recording
+        SimulationConfig config;
+        config.numFloors = numFloors;
+        config.numElevators = numElevators;
+        config.seed = seed;
+        session = SessionLog(config);
+
+        sentEvents = 0;
+        lastCars = snapshot();
+        updateTimer->start();
+        emit started(lastCars);
+    });
+}
+
+void SimulationEngine::stop()
+{
+    post([this]() {
+        // let the viewer see everything that happened before the end
+        sendUpdate();
+        shutdown();
+        emit stopped();
+    });
+}
+
+void SimulationEngine::setSessionFile(const QString &fileName)
+{
+    post([this, fileName]() { sessionFile = fileName; });
+}
+
+void SimulationEngine::execute(commandType type, int elevatorId, int floor, bool on)
+{
+    if (ecs == nullptr)
+    {
+        return;
+    }
+
+    // stamp the command with the control system's clock, which is what a replay runs on
+    SessionCommand command;
+    command.time = ecs->now();
+    command.type = type;
+    command.elevatorId = elevatorId;
+    command.floor = floor;
+    command.on = on;
+    session.record(command);
+    SessionLog::apply(command, ecs);
+}
+
+void SimulationEngine::shutdown()
+{
+    updateTimer->stop();
+
+    // keep the session that just ended
+    if (ecs != nullptr && !sessionFile.isEmpty())
+    {
+        session.setDuration(ecs->now());
+        QString error;
+        if (!session.save(sessionFile, error))
+        {
+            qWarning() << error;
+        }
+    }
+
+    // delete elevator control system
+    delete ecs;
+    ecs = nullptr;
+
+    // delete elevators
+    for (int i = 0; i < elevators.size(); i++)
+    {
+        delete elevators[i];
+    }
+    elevators.clear();
+    lastCars.clear();
+}
+
+QVector<CarSnapshot> SimulationEngine::snapshot()
+{
+    // read straight from the control system's car table
+    QVector<CarSnapshot> cars;
+    if (ecs == nullptr)
+    {
+        return cars;
+    }
+    ecs->updateCarPositions();
+    const CarStateTable &carStates = ecs->getCarStates();
+    cars.reserve(carStates.size());
+    for (int i = 1; i <= carStates.size(); i++)
+    {
+        CarSnapshot car;
+        car.floor = carStates.floor(i);
+        car.destination = carStates.destination(i);
+        car.state = carStates.state(i);
+        car.door = carStates.door(i);
+        cars.push_back(car);
+    }
+    return cars;
+}
+
+void SimulationEngine::sendUpdate()
+{
+    if (ecs == nullptr)
+    {
+        return;
+    }
+
+    // copy the events recorded since the last update, skipping any the ring buffer already dropped
+    const EventLog &eventLog = ecs->getEventLog();
+    sentEvents = qMax(sentEvents, eventLog.begin());
+    QVector<LogEvent> events;
+    events.reserve(int(eventLog.end() - sentEvents));
+    for (; sentEvents < eventLog.end(); sentEvents++)
+    {
+        events.push_back(eventLog.at(sentEvents));
+    }
+
+    // stay quiet while nothing happens
+    QVector<CarSnapshot> cars = snapshot();
+    if (events.isEmpty() && cars == lastCars)
+    {
+        return;
+    }
+    lastCars = cars;
+    emit updated(events, cars);
+}
+
+void SimulationEngine::floorRequest(int floor, direction dir)
+{
+    post([this, floor, dir]() { execute(commandType::floorRequest, 0, floor, dir == direction::up); });
+}
+
+void SimulationEngine::carRequest(int elevatorId, int floor)
+{
+    post([this, elevatorId, floor]() { execute(commandType::carRequest, elevatorId, floor); });
+}
+
+void SimulationEngine::helpRequest(int elevatorId)
+{
+    post([this, elevatorId]() { execute(commandType::helpRequest, elevatorId); });
+}
+
+void SimulationEngine::openDoorRequest(int elevatorId)
+{
+    post([this, elevatorId]() { execute(commandType::openDoorRequest, elevatorId); });
+}
+
+void SimulationEngine::closeDoorRequest(int elevatorId)
+{
+    post([this, elevatorId]() { execute(commandType::closeDoorRequest, elevatorId); });
+}
+
+void SimulationEngine::setDoorBlocked(int elevatorId, bool doorBlocked)
+{
+    post([this, elevatorId, doorBlocked]() { execute(commandType::doorBlocked, elevatorId, 0, doorBlocked); });
+}
+
+void SimulationEngine::setOverload(int elevatorId, bool overload)
+{
+    post([this, elevatorId, overload]() { execute(commandType::overload, elevatorId, 0, overload); });
+}
+
+void SimulationEngine::fireAlarm()
+{
+    post([this]() { execute(commandType::fireAlarm); });
+}
+
+void SimulationEngine::powerOutage()
+{
+    post([this]() { execute(commandType::powerOutage); });
+}
+
+SimulationEngine::~SimulationEngine()
+{
+    shutdown();
+}
@@ -0,0 +1,129 @@
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include "ElevatorControlSystem.h"
+#include "ElevatorCar.h"
+#include "EventLog.h"
+#include "SessionLog.h"
+#include "enums.h"
+#include <QMetaType>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+// where one car is and what it is doing, as last seen by the engine
+struct CarSnapshot
+{
+    int floor;
+    int destination;
+    elevatorState state;
+    doorStatus door;
+
+    bool operator==(const CarSnapshot &other) const
+    {
+        return floor == other.floor && destination == other.destination && state == other.state && door == other.door;
+    }
+
+    bool operator!=(const CarSnapshot &other) const { return !(*this == other); }
+};
+
+Q_DECLARE_METATYPE(LogEvent)
+Q_DECLARE_METATYPE(CarSnapshot)
+
+// runs the control system and its cars on whichever thread the engine is moved to.
+// the request functions can be called from any thread, they queue the command for the engine's thread.
+// every command is recorded as it is applied, see SessionLog for replaying a session.
+// new events and car positions are sent back through updated() at most once per frame.
+class SimulationEngine : public QObject
+{
+    Q_OBJECT
+private:
+    ElevatorControlSystem *ecs = nullptr;
+    QVector<ElevatorCar *> elevators;
+    QTimer *updateTimer;
+    quint64 sentEvents = 0; // next event log record to send
+    QVector<CarSnapshot> lastCars;
+    SessionLog session;
+    QString sessionFile; // where each session is saved when it ends, empty to keep none
+
+    void post(std::function<void()> command);
+
+    void execute(commandType type, int elevatorId = 0, int floor = 0, bool on = false);
+
+    QVector<CarSnapshot> snapshot();
+
+    void shutdown();
+
+private slots:
+    void sendUpdate();
+
+signals:
+    void started(QVector<CarSnapshot> cars);
+
+    void updated(QVector<LogEvent> events, QVector<CarSnapshot> cars);
+
+    void stopped();
+
+public:
+    SimulationEngine(QObject *parent = nullptr);
+
+    ~SimulationEngine();
+
+    void start(int numElevators, int numFloors, quint32 seed = 1);
+
+    void setSessionFile(const QString &fileName);
+
+    void stop();
+
+    void floorRequest(int floor, direction dir);
+
+    void carRequest(int elevatorId, int floor);
+
+    void helpRequest(int elevatorId);
+
+    void openDoorRequest(int elevatorId);
+
+    void closeDoorRequest(int elevatorId);
+
+    void setDoorBlocked(int elevatorId, bool doorBlocked);
+
+    void setOverload(int elevatorId, bool overload);
+
+    void fireAlarm();
+
+    void powerOutage();
+};
+
+#endif // SIMULATIONENGINE_H
+
+// get uml format for this class like this:
+
+// -ecs: ElevatorControlSystem *
+// -elevators: QVector<ElevatorCar *>
+// -updateTimer: QTimer *
+// -sentEvents: quint64
+// -lastCars: QVector<CarSnapshot>
+// -session: SessionLog
+// -sessionFile: QString
+
+// +start(int, int, quint32)
+// +setSessionFile(const QString &)
+// +stop()
+// +floorRequest(int, direction)
+// +carRequest(int, int)
+// +helpRequest(int)
+// +openDoorRequest(int)
+// +closeDoorRequest(int)
+// +setDoorBlocked(int, bool)
+// +setOverload(int, bool)
+// +fireAlarm()
+// +powerOutage()
+// +started(QVector<CarSnapshot>)
+// +updated(QVector<LogEvent>, QVector<CarSnapshot>)
+// +stopped()
+// -post(function<void()>)
+// -execute(commandType, int, int, bool)
+// -snapshot(): QVector<CarSnapshot>
+// -shutdown()
+// -sendUpdate()
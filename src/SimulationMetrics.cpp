@@ -0,0 +1,132 @@
+#include "SimulationMetrics.h"
+
+const qint64 SimulationMetrics::handlingWindow;
+
+SimulationMetrics::SimulationMetrics(int numElevators, int numFloors)
+{
+    // indexed by floor and elevator number, so slot 0 is unused
+    upCallTimes.fill(-1, numFloors + 1);
+    downCallTimes.fill(-1, numFloors + 1);
+    busySince.fill(-1, numElevators + 1);
+    busyTime.fill(0, numElevators + 1);
+}
+
+void SimulationMetrics::hallCallPlaced(int floor, direction dir, qint64 time)
+{
+    // pressing a lit button again does not restart the wait
+    qint64 &placedTime = dir == direction::up ? upCallTimes[floor] : downCallTimes[floor];
+    if (placedTime != -1)
+    {
+        return;
+    }
+    hallCallBacklog.record(outstandingCalls);
+    placedTime = time;
+    outstandingCalls++;
+}
+
+void SimulationMetrics::hallCallAnswered(int floor, qint64 time)
+{
+    // an open door answers both buttons at the floor
+    answerCall(upCallTimes[floor], time);
+    answerCall(downCallTimes[floor], time);
+}
+
+void SimulationMetrics::kioskCallPlaced()
+{
+    hallCallBacklog.record(outstandingCalls);
+    outstandingCalls++;
+}
+
+void SimulationMetrics::kioskCallAnswered(qint64 placedTime, qint64 time)
+{
+    answerCall(placedTime, time);
+}
+
+void SimulationMetrics::answerCall(qint64 &placedTime, qint64 time)
+{
+    if (placedTime == -1)
+    {
+        return;
+    }
+    hallCallTimes.record(time - placedTime);
+    placedTime = -1;
+    outstandingCalls--;
+}
+
+void SimulationMetrics::passengerBoarded(qint64 arrivalTime, qint64 time)
+{
+    waitTimes.record(time - arrivalTime);
+}
+
+void SimulationMetrics::passengerDelivered(qint64 arrivalTime, qint64 boardTime, qint64 time)
+{
+    travelTimes.record(time - boardTime);
+    journeyTimes.record(time - arrivalTime);
+
+    // passengers delivered in the busiest five minutes, wherever they start.
+    // the clock only goes forward, so the window slides by dropping the oldest drop-offs
+    recentDeliveries.push_back(time);
+    while (time - recentDeliveries.front() >= handlingWindow)
+    {
+        recentDeliveries.pop_front();
+    }
+    busiestDeliveries = qMax(busiestDeliveries, int(recentDeliveries.size()));
+}
+
+void SimulationMetrics::stopQueued(int queueLength)
+{
+    carQueueLengths.record(queueLength);
+}
+
+void SimulationMetrics::passengersExchanged(int load)
+{
+    carLoads.record(load);
+}
+
+void SimulationMetrics::carStateChanged(int elevatorId, elevatorState state, qint64 time)
+{
+    // a car is busy whenever it is not idle, moving or standing with its door open
+    if (state == elevatorState::idle)
+    {
+        if (busySince[elevatorId] != -1)
+        {
+            busyTime[elevatorId] += time - busySince[elevatorId];
+            busySince[elevatorId] = -1;
+        }
+    }
+    else if (busySince[elevatorId] == -1)
+    {
+        busySince[elevatorId] = time;
+    }
+}
+
+double SimulationMetrics::utilisation(int elevatorId, qint64 now) const
+{
+    // share of the time so far the car spent busy
+    if (now <= 0)
+    {
+        return 0;
+    }
+    qint64 busy = busyTime[elevatorId];
+    if (busySince[elevatorId] != -1)
+    {
+        busy += now - busySince[elevatorId];
+    }
+    return double(busy) / now;
+}
+
+double SimulationMetrics::utilisation(qint64 now) const
+{
+    // average over the whole fleet
+    int numElevators = busyTime.size() - 1;
+    if (numElevators <= 0)
+    {
+        return 0;
+    }
+    double total = 0;
+    for (int i = 1; i <= numElevators; i++)
+    {
+        total += utilisation(i, now);
+    }
+    return total / numElevators;
+}
@@ -0,0 +1,121 @@
+#ifndef SIMULATIONMETRICS_H
+#define SIMULATIONMETRICS_H
+
+#include "Histogram.h"
+#include "enums.h"
+#include <QVector>
+#include <deque>
+
+// timestamps hall calls, pick-ups and drop-offs and keeps running histograms of how well they are served.
+// all times are in milliseconds on the control system's clock.
+class SimulationMetrics
+{
+private:
+    QVector<qint64> upCallTimes;   // when each floor's up call was placed, -1 if none is waiting
+    QVector<qint64> downCallTimes; // same for down calls
+    int outstandingCalls = 0;
+
+    QVector<qint64> busySince; // when each car stopped being idle, -1 while it is idle
+    QVector<qint64> busyTime;  // total time each car spent busy before that
+
+    Histogram hallCallTimes;    // call placed until a car opens its door at the floor
+    Histogram waitTimes;        // passenger arrival until boarding
+    Histogram travelTimes;      // boarding until drop-off
+    Histogram journeyTimes;     // arrival until drop-off
+    Histogram hallCallBacklog;  // calls already waiting when a new one is placed
+    Histogram carQueueLengths;  // stops queued in a car when it is given another one
+    Histogram carLoads;         // riders aboard once everyone at a stop has got on and off
+
+    std::deque<qint64> recentDeliveries; // drop-offs in the last handling capacity window
+    int busiestDeliveries = 0;           // most drop-offs seen in any one window
+
+    void answerCall(qint64 &placedTime, qint64 time);
+
+public:
+    // handling capacity is quoted per five minutes
+    static const qint64 handlingWindow = 300000;
+
+    SimulationMetrics(int numElevators = 0, int numFloors = 0);
+
+    void hallCallPlaced(int floor, direction dir, qint64 time);
+
+    void hallCallAnswered(int floor, qint64 time);
+
+    // a destination kiosk call is one rider's and is answered by the car they were given
+    void kioskCallPlaced();
+
+    void kioskCallAnswered(qint64 placedTime, qint64 time);
+
+    void passengerBoarded(qint64 arrivalTime, qint64 time);
+
+    void passengerDelivered(qint64 arrivalTime, qint64 boardTime, qint64 time);
+
+    void stopQueued(int queueLength);
+
+    void passengersExchanged(int load);
+
+    void carStateChanged(int elevatorId, elevatorState state, qint64 time);
+
+    int getOutstandingCalls() const { return outstandingCalls; }
+
+    const Histogram &getHallCallTimes() const { return hallCallTimes; }
+
+    const Histogram &getWaitTimes() const { return waitTimes; }
+
+    const Histogram &getTravelTimes() const { return travelTimes; }
+
+    const Histogram &getJourneyTimes() const { return journeyTimes; }
+
+    const Histogram &getHallCallBacklog() const { return hallCallBacklog; }
+
+    const Histogram &getCarQueueLengths() const { return carQueueLengths; }
+
+    const Histogram &getCarLoads() const { return carLoads; }
+
+    int handlingCapacity() const { return busiestDeliveries; }
+
+    double utilisation(int elevatorId, qint64 now) const;
+
+    double utilisation(qint64 now) const;
+};
+
+#endif // SIMULATIONMETRICS_H
+
+// get uml format for this class like this:
+
+// -upCallTimes: QVector<qint64>
+// -downCallTimes: QVector<qint64>
+// -outstandingCalls: int
+// -busySince: QVector<qint64>
+// -busyTime: QVector<qint64>
+// -hallCallTimes: Histogram
+// -waitTimes: Histogram
+// -travelTimes: Histogram
+// -journeyTimes: Histogram
+// -hallCallBacklog: Histogram
+// -carQueueLengths: Histogram
+// -carLoads: Histogram
+// -recentDeliveries: std::deque<qint64>
+// -busiestDeliveries: int
+
+// +hallCallPlaced(int, direction, qint64)
+// +hallCallAnswered(int, qint64)
+// +kioskCallPlaced()
+// +kioskCallAnswered(qint64, qint64)
+// +passengerBoarded(qint64, qint64)
+// +passengerDelivered(qint64, qint64, qint64)
+// +stopQueued(int)
+// +passengersExchanged(int)
+// +carStateChanged(int, elevatorState, qint64)
+// +getOutstandingCalls(): int
+// +getHallCallTimes(): Histogram
+// +getWaitTimes(): Histogram
+// +getTravelTimes(): Histogram
+// +getJourneyTimes(): Histogram
+// +getHallCallBacklog(): Histogram
+// +getCarQueueLengths(): Histogram
+// +getCarLoads(): Histogram
+// +handlingCapacity(): int
+// +utilisation(int, qint64): double
+// +utilisation(qint64): double
+// -answerCall(qint64 &, qint64)
@@ -0,0 +1,361 @@
+#include "SimulationRunner.h"
+#include "SessionLog.h"
+#include <QElapsedTimer>
+
+const qint64 SimulationRunner::traceDrainTime;
+
+SimulationRunner::SimulationRunner(const SimulationConfig &config) : config(config), layout(config.numFloors, config.numElevators), rng(config.seed), traffic(config.numFloors, config.traffic, config.arrivalsPerMinute, config.seed)
+{
+    // a building with car groups takes its floors and cars from them
+    if (!config.groups.isEmpty())
+    {
+        QString error;
+        if (!layout.parse(config.groups, error))
+        {
+            qWarning() << error;
+            layout = BuildingLayout(config.numFloors, config.numElevators);
+        }
+        this->config.numFloors = layout.getNumFloors();
+        this->config.numElevators = layout.getNumElevators();
+        traffic = TrafficGenerator(layout.getNumFloors(), config.traffic, config.arrivalsPerMinute, config.seed);
+    }
+
+    // one control system per group on the virtual clock, numbering floors like the building
+    for (int group = 0; group < layout.getNumGroups(); group++)
+    {
+        const CarGroup &cars = layout.getGroup(group);
+        ElevatorControlSystem *ecs = new ElevatorControlSystem(cars.numElevators, layout.getNumFloors(), &scheduler);
+        ecs->setSeed(config.seed + quint32(group));
+        ecs->setDispatchStrategy(DispatchStrategyRegistry::instance().create(config.strategy));
+        ecs->setReassignInterval(config.reassignInterval);
+        controllers.push_back(ecs);
+        firstElevator.push_back(elevators.size());
+
+        // create elevators at seeded random floors the group serves, so runs can be repeated
+        std::uniform_int_distribution<int> floorDistribution(1, cars.floors.size());
+        for (int i = 0; i < cars.numElevators; i++)
+        {
+            ElevatorCar *elevator = new ElevatorCar(i + 1, cars.floors[floorDistribution(rng) - 1], ecs, config.ordering);
+            elevator->setMoveInterval(config.moveTime);
+            elevator->setDoorInterval(config.doorTime);
+            elevator->setCapacity(config.capacity);
+            elevator->setPassengerInterval(config.passengerTime);
+            elevator->setMotionProfile(MotionProfile(config.speed, config.acceleration, config.jerk, config.floorHeight));
+            elevators.push_back(elevator);
+            ecs->addElevator(elevator);
+        }
+    }
+
+    waiting.resize(layout.getNumGroups() * (this->config.numFloors + 1));
+    riding.resize(elevators.size());
+
+    // a trace has calls but no passengers to get on and off, and names its cars building wide
+    if (!config.trace.isEmpty())
+    {
+        if (layout.getNumGroups() > 1)
+        {
+            qWarning() << "call logs play on a single group, ignoring" << config.trace;
+        }
+        trace = new CallTrace(this->config.numFloors, controllers[0]->getNumElevators());
+        QString error;
+        if (!trace->open(config.trace, error))
+        {
+            qWarning() << error;
+        }
+        return;
+    }
+    for (int group = 0; group < controllers.size(); group++)
+    {
+        connect(controllers[group], &ElevatorControlSystem::doorOpened, this, [this, group](int elevatorId, int floor) { handleDoorOpened(group, elevatorId, floor); });
+    }
+}
+
+SimulationResult SimulationRunner::run()
+{
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    if (trace == nullptr)
+    {
+        scheduleNextArrival();
+        scheduler.runUntil(config.duration);
+        return finish(wallClock.elapsed());
+    }
+
+    // a whole trace runs until its last call and then a while longer
+    scheduleNextCall();
+    if (config.duration == 0)
+    {
+        while (!traceFinished && scheduler.step())
+        {
+        }
+        scheduler.runUntil(scheduler.now() + traceDrainTime);
+    }
+    else
+    {
+        scheduler.runUntil(config.duration);
+    }
+    return finish(wallClock.elapsed());
+}
+
+SimulationResult SimulationRunner::replay(const SessionLog &session)
+{
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    // nobody gets on or off, the recorded commands are all the building sees
+    SimulationRunner runner(session.getConfig());
+    runner.controllers[0]->disconnect(&runner);
+
+    // scheduled up front, so a command goes before anything the cars schedule for the same millisecond
+    for (const SessionCommand &command : session.getCommands())
+    {
+        ElevatorControlSystem *ecs = runner.controllers[0];
+        runner.scheduler.scheduleAt(command.time, [ecs, command]() { SessionLog::apply(command, ecs); });
+    }
+    runner.scheduler.runUntil(runner.config.duration);
+    return runner.finish(wallClock.elapsed());
+}
+
+SimulationResult SimulationRunner::finish(qint64 wallTime)
+{
+    result.simulatedTime = scheduler.now();
+    result.events = scheduler.getProcessedEvents();
+    result.wallTime = wallTime;
+    result.traceSkipped = trace != nullptr ? trace->getSkipped() : 0;
+
+    // passengers are followed across the building, they may ride more than one group
+    result.waitTimes = passengerMetrics.getWaitTimes();
+    result.travelTimes = passengerMetrics.getTravelTimes();
+    result.journeyTimes = passengerMetrics.getJourneyTimes();
+    result.handlingCapacity = passengerMetrics.handlingCapacity();
+
+    // copy the distributions out before the control systems go away, utilisation is weighted by cars
+    double busyCars = 0;
+    for (int group = 0; group < controllers.size(); group++)
+    {
+        const SimulationMetrics &metrics = controllers[group]->getMetrics();
+        result.hallCallTimes.merge(metrics.getHallCallTimes());
+        result.hallCallBacklog.merge(metrics.getHallCallBacklog());
+        result.carQueueLengths.merge(metrics.getCarQueueLengths());
+        result.carLoads.merge(metrics.getCarLoads());
+        busyCars += metrics.utilisation(result.simulatedTime) * controllers[group]->getNumElevators();
+
+        // one group gives its own digest, more are folded in order
+        quint64 digest = controllers[group]->getEventLog().getDigest();
+        result.eventDigest = group == 0 ? digest : (result.eventDigest * 1099511628211ULL) ^ digest;
+    }
+    result.utilisation = elevators.isEmpty() ? 0 : busyCars / elevators.size();
+    return result;
+}
+
+void SimulationRunner::scheduleNextArrival()
+{
+    // stop feeding passengers once the run is over
+    PassengerArrival arrival = traffic.next();
+    if (arrival.time > config.duration)
+    {
+        return;
+    }
+    scheduler.scheduleAt(arrival.time, [this, arrival]() { passengerArrives(arrival); });
+}
+
+void SimulationRunner::scheduleNextCall()
+{
+    // one call is read ahead, the rest stay in the file until their time comes
+    TraceCall call;
+    if (!trace->next(call) || (config.duration > 0 && call.time > config.duration))
+    {
+        traceFinished = true;
+        return;
+    }
+    scheduler.scheduleAt(call.time, [this, call]() { playCall(call); });
+}
+
+void SimulationRunner::playCall(const TraceCall &call)
+{
+    result.traceCalls++;
+    scheduleNextCall();
+
+    if (call.elevatorId == 0)
+    {
+        controllers[0]->floorRequest(call.floor, call.dir);
+    }
+    else
+    {
+        controllers[0]->carRequest(call.elevatorId, call.floor);
+    }
+}
+
+void SimulationRunner::passengerArrives(const PassengerArrival &arrival)
+{
+    Passenger passenger;
+    passenger.arrivalTime = arrival.time;
+    passenger.boardTime = -1;
+    passenger.floor = arrival.origin;
+    passenger.destination = arrival.destination;
+    passenger.car = 0;
+    layout.route(passenger.floor, passenger.destination, passenger.group, passenger.alight);
+    result.passengersArrived++;
+
+    scheduleNextArrival();
+    callFor(passenger);
+}
+
+void SimulationRunner::callFor(Passenger passenger)
+{
+    // with destination dispatch the kiosk names the car, otherwise any car waiting with its door open will do
+    ElevatorControlSystem *ecs = controllers[passenger.group];
+    int openElevator;
+    if (config.destinationDispatch)
+    {
+        // no car at all only when every car is full with its door open here, then the rider presses up or down
+        int car = ecs->destinationRequest(passenger.floor, passenger.alight);
+        passenger.car = qMax(car, 0);
+        bool open = car != -1 && ecs->getCarStates().floor(car) == passenger.floor && ecs->getCarStates().door(car) == doorStatus::open;
+        openElevator = open ? car : -1;
+    }
+    else
+    {
+        openElevator = ecs->getCarStates().openAt(passenger.floor);
+    }
+    if (openElevator != -1)
+    {
+        board(passenger.group, openElevator, passenger);
+        ElevatorCar *elevator = ecs->getElevator(openElevator);
+        elevator->exchangePassengers(0, 1);
+        ecs->getMetrics().passengersExchanged(elevator->getLoad());
+        return;
+    }
+
+    // press the hall button unless someone waiting here already pressed it
+    direction dir = passenger.alight > passenger.floor ? direction::up : direction::down;
+    QVector<Passenger> &atFloor = waitingAt(passenger.group, passenger.floor);
+    bool pressed = false;
+    for (const Passenger &other : atFloor)
+    {
+        if ((other.alight > other.floor) == (dir == direction::up))
+        {
+            pressed = true;
+            break;
+        }
+    }
+    atFloor.push_back(passenger);
+    if (!pressed && passenger.car == 0)
+    {
+        ecs->floorRequest(passenger.floor, dir);
+    }
+}
+
+void SimulationRunner::board(int group, int elevatorId, Passenger passenger)
+{
+    // a wait is counted up to the first car, changing cars is part of the journey
+    if (passenger.boardTime == -1)
+    {
+        passenger.boardTime = scheduler.now();
+        passengerMetrics.passengerBoarded(passenger.arrivalTime, passenger.boardTime);
+        result.passengersBoarded++;
+    }
+
+    riding[firstElevator[group] + elevatorId - 1].push_back(passenger);
+    controllers[group]->carRequest(elevatorId, passenger.alight);
+}
+
+void SimulationRunner::handleDoorOpened(int group, int elevatorId, int floor)
+{
+    // passengers for this floor get off, either where they are going or to change cars
+    ElevatorControlSystem *ecs = controllers[group];
+    ElevatorCar *elevator = ecs->getElevator(elevatorId);
+    QVector<Passenger> &inCar = riding[firstElevator[group] + elevatorId - 1];
+    QVector<Passenger> changing;
+    int alighting = 0;
+    for (int i = inCar.size() - 1; i >= 0; i--)
+    {
+        if (inCar[i].alight == floor)
+        {
+            if (inCar[i].destination == floor)
+            {
+                passengerMetrics.passengerDelivered(inCar[i].arrivalTime, inCar[i].boardTime, scheduler.now());
+                result.passengersDelivered++;
+            }
+            else
+            {
+                changing.push_back(inCar[i]);
+            }
+            inCar.remove(i);
+            alighting++;
+        }
+    }
+    elevator->exchangePassengers(alighting, 0);
+
+    // everyone waiting here for this car or for any car gets on, in the order they came, while there is room
+    QVector<Passenger> &atFloor = waitingAt(group, floor);
+    QVector<Passenger> turnedAway;
+    int room = elevator->getFreeSpace();
+    int boarding = 0;
+    int kept = 0;
+    bool up = false;
+    bool down = false;
+    for (int i = 0; i < atFloor.size(); i++)
+    {
+        Passenger passenger = atFloor[i];
+        if ((passenger.car == 0 || passenger.car == elevatorId) && boarding < room)
+        {
+            board(group, elevatorId, passenger);
+            boarding++;
+        }
+        else if (passenger.car == elevatorId)
+        {
+            turnedAway.push_back(passenger);
+        }
+        else
+        {
+            if (passenger.car == 0)
+            {
+                (passenger.alight > floor ? up : down) = true;
+            }
+            atFloor[kept++] = passenger;
+        }
+    }
+    atFloor.resize(kept);
+    elevator->exchangePassengers(0, boarding);
+    ecs->getMetrics().passengersExchanged(elevator->getLoad());
+
+    // anyone left behind presses the button again, the full car is not sent back for them
+    if (up)
+    {
+        ecs->floorRequest(floor, direction::up);
+    }
+    if (down)
+    {
+        ecs->floorRequest(floor, direction::down);
+    }
+
+    // riders the kiosk sent to this car that did not fit ask the kiosk again
+    for (const Passenger &passenger : turnedAway)
+    {
+        callFor(passenger);
+    }
+
+    // passengers changing cars go on to the next group from here, in the order they got on
+    for (int i = changing.size() - 1; i >= 0; i--)
+    {
+        Passenger passenger = changing[i];
+        passenger.floor = floor;
+        layout.route(passenger.floor, passenger.destination, passenger.group, passenger.alight);
+        callFor(passenger);
+    }
+}
+
+SimulationRunner::~SimulationRunner()
+{
+    delete trace;
+    for (int i = 0; i < controllers.size(); i++)
+    {
+        delete controllers[i];
+    }
+    for (int i = 0; i < elevators.size(); i++)
+    {
+        delete elevators[i];
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef SIMULATIONRUNNER_H
+#define SIMULATIONRUNNER_H
+
+#include "BuildingLayout.h"
+#include "CallTrace.h"
+#include "ElevatorControlSystem.h"
+#include "EventScheduler.h"
+#include "Histogram.h"
+#include "TrafficGenerator.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <random>
+
+class SessionLog;
+
+// settings for one headless simulation run
+struct SimulationConfig
+{
+    int numFloors = 10;
+    int numElevators = 3;
+    QString groups;                // car groups as name:cars:floors;..., see BuildingLayout, empty for one group serving every floor
+    QString traffic = "uniform";
+    QString trace;                 // csv log of hall and car calls played instead of traffic, see CallTrace
+    QString strategy = "closest";
+    bool destinationDispatch = false; // riders give their floor at the hall and are told which car to take, instead of pressing up or down
+    queueOrdering ordering = queueOrdering::look;
+    qint64 duration = 3600000;     // simulated milliseconds, 0 plays a whole trace
+    double arrivalsPerMinute = 10; // passengers per minute across the building
+    quint32 seed = 1;
+    int moveTime = 3000;  // milliseconds to travel one floor
+    int doorTime = 10000; // milliseconds the door stays open
+    int reassignInterval = 0;  // milliseconds between reassignments of open hall calls, 0 for never
+    int capacity = 0;          // riders per car, 0 for no limit
+    int passengerTime = 0;     // milliseconds each rider getting on or off keeps the door open longer
+    double speed = 0;          // rated car speed in metres per second, 0 moves one floor per moveTime instead
+    double acceleration = 1.0; // metres per second squared
+    double jerk = 1.5;         // metres per second cubed
+    double floorHeight = 3.5;  // metres
+};
+
+// throughput and latency numbers collected from one run, times are in milliseconds
+struct SimulationResult
+{
+    int passengersArrived = 0;
+    int passengersBoarded = 0;
+    int passengersDelivered = 0;
+    Histogram waitTimes;
+    Histogram travelTimes;
+    Histogram journeyTimes;
+    Histogram hallCallTimes;
+    Histogram hallCallBacklog;
+    Histogram carQueueLengths;
+    Histogram carLoads;
+    int handlingCapacity = 0; // passengers delivered in the busiest five minutes
+    int traceCalls = 0;       // calls played from a trace
+    int traceSkipped = 0;     // trace lines that could not be played
+    double utilisation = 0;
+    qint64 simulatedTime = 0;
+    quint64 events = 0;
+    quint64 eventDigest = 0; // hash of the event log, equal for runs that did exactly the same things
+    qint64 wallTime = 0;
+
+    // fold another run into this one, utilisation is weighted by simulated time
+    void merge(const SimulationResult &other)
+    {
+        qint64 totalTime = simulatedTime + other.simulatedTime;
+        if (totalTime > 0)
+        {
+            utilisation = (utilisation * simulatedTime + other.utilisation * other.simulatedTime) / totalTime;
+        }
+        passengersArrived += other.passengersArrived;
+        passengersBoarded += other.passengersBoarded;
+        passengersDelivered += other.passengersDelivered;
+        waitTimes.merge(other.waitTimes);
+        travelTimes.merge(other.travelTimes);
+        journeyTimes.merge(other.journeyTimes);
+        hallCallTimes.merge(other.hallCallTimes);
+        hallCallBacklog.merge(other.hallCallBacklog);
+        carQueueLengths.merge(other.carQueueLengths);
+        carLoads.merge(other.carLoads);
+        handlingCapacity = qMax(handlingCapacity, other.handlingCapacity);
+        traceCalls += other.traceCalls;
+        traceSkipped += other.traceSkipped;
+        simulatedTime = totalTime;
+        events += other.events;
+        eventDigest = (eventDigest * 1099511628211ULL) ^ other.eventDigest; // folded in order, like the groups of one run
+        wallTime += other.wallTime;
+    }
+};
+
+// builds a building on a virtual clock, feeds it passengers and measures how they get served
+class SimulationRunner : public QObject
+{
+    Q_OBJECT
+private:
+    struct Passenger
+    {
+        qint64 arrivalTime;
+        qint64 boardTime; // first time on a car, -1 until then
+        int floor;        // where they wait, or got on
+        int alight;       // where they get off the car they are on or waiting for
+        int destination;
+        int group;        // the group of that car
+        int car;          // the car they were told to take with destination dispatch, 0 for any car
+    };
+
+    SimulationConfig config;
+    SimulationResult result;
+    EventScheduler scheduler;
+    BuildingLayout layout;
+    QVector<ElevatorControlSystem *> controllers; // one per car group, each with its own cars
+    QVector<int> firstElevator;                    // index in elevators of each group's car 1
+    QVector<ElevatorCar *> elevators;
+    SimulationMetrics passengerMetrics;           // waits and journeys across the whole building
+    std::mt19937 rng;
+    TrafficGenerator traffic;
+    CallTrace *trace = nullptr; // only when playing a trace
+    bool traceFinished = false;
+
+    static const qint64 traceDrainTime = 600000; // milliseconds to let the last calls of a whole trace be answered
+
+    QVector<QVector<Passenger>> waiting; // indexed by group * (floors + 1) + floor
+    QVector<QVector<Passenger>> riding;  // indexed like elevators
+
+    QVector<Passenger> &waitingAt(int group, int floor) { return waiting[group * (config.numFloors + 1) + floor]; }
+
+    void scheduleNextArrival();
+    void scheduleNextCall();
+    void playCall(const TraceCall &call);
+    void passengerArrives(const PassengerArrival &arrival);
+    void callFor(Passenger passenger);
+    void board(int group, int elevatorId, Passenger passenger);
+    void handleDoorOpened(int group, int elevatorId, int floor);
+    SimulationResult finish(qint64 wallTime);
+
+public:
+    SimulationRunner(const SimulationConfig &config);
+
+    ~SimulationRunner();
+
+    SimulationResult run();
+
+    // plays a recorded session back on the virtual clock instead of generating passengers
+    static SimulationResult replay(const SessionLog &session);
+};
+
+#endif // SIMULATIONRUNNER_H
+
+// get uml format for this class like this:
+
+// -config: SimulationConfig
+// -result: SimulationResult
+// -scheduler: EventScheduler
+// -layout: BuildingLayout
+// -controllers: QVector<ElevatorControlSystem *>
+// -firstElevator: QVector<int>
+// -elevators: QVector<ElevatorCar *>
+// -passengerMetrics: SimulationMetrics
+// -waiting: QVector<QVector<Passenger>>
+// -riding: QVector<QVector<Passenger>>
+// -traffic: TrafficGenerator
+// -trace: CallTrace *
+// -traceFinished: bool
+// -traceDrainTime: qint64
+
+// +run(): SimulationResult
+// +replay(const SessionLog &): SimulationResult
+// -scheduleNextArrival()
+// -scheduleNextCall()
+// -playCall(const TraceCall &)
+// -passengerArrives(const PassengerArrival &)
+// -callFor(Passenger)
+// -board(int, int, Passenger)
+// -handleDoorOpened(int, int, int)
+// -finish(qint64): SimulationResult
+// -waitingAt(int, int): QVector<Passenger>
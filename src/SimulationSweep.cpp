@@ -0,0 +1,45 @@
+#include "SimulationSweep.h"
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+// one simulation run, writing into its own slot of the results
+class SweepRun : public QRunnable
+{
+private:
+    SimulationConfig config;
+    SimulationResult *result;
+
+public:
+    SweepRun(const SimulationConfig &config, SimulationResult *result) : config(config), result(result) {}
+
+    void run() override
+    {
+        SimulationRunner runner(config);
+        *result = runner.run();
+    }
+};
+
+SimulationSweep::SimulationSweep(int threads) : threads(threads)
+{
+    // one thread per core unless told otherwise
+    if (this->threads <= 0)
+    {
+        this->threads = qMax(1, QThread::idealThreadCount());
+    }
+}
+
+QVector<SimulationResult> SimulationSweep::run()
+{
+    // results are sized up front so every run writes to its own slot without locking
+    QVector<SimulationResult> results(configs.size());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int i = 0; i < configs.size(); i++)
+    {
+        pool.start(new SweepRun(configs[i], &results[i]));
+    }
+    pool.waitForDone();
+    return results;
+}
@@ -0,0 +1,38 @@
+#ifndef SIMULATIONSWEEP_H
+#define SIMULATIONSWEEP_H
+
+#include "SimulationRunner.h"
+#include <QVector>
+
+// runs many independent headless simulations side by side on a thread pool.
+// every run has its own scheduler, control system and cars, so runs share nothing but the
+// strategy registry, and the results are the same whatever the number of threads.
+class SimulationSweep
+{
+private:
+    QVector<SimulationConfig> configs;
+    int threads;
+
+public:
+    SimulationSweep(int threads = 0);
+
+    void add(const SimulationConfig &config) { configs.push_back(config); }
+
+    int size() const { return configs.size(); }
+
+    const SimulationConfig &at(int i) const { return configs[i]; }
+
+    QVector<SimulationResult> run();
+};
+
+#endif // SIMULATIONSWEEP_H
+
+// get uml format for this class like this:
+
+// -configs: QVector<SimulationConfig>
+// -threads: int
+
+// +add(const SimulationConfig &)
+// +size(): int
+// +at(int): SimulationConfig
+// +run(): QVector<SimulationResult>
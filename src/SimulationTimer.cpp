@@ -0,0 +1,90 @@
+#include "SimulationTimer.h"
+#include <QPointer>
+
+SimulationTimer::SimulationTimer(EventScheduler *scheduler, QObject *parent) : QObject(parent), scheduler(scheduler), timer(nullptr), interval(0), active(false), generation(0)
+{
+    // real time mode, let a QTimer do the work
+    if (scheduler == nullptr)
+    {
+        timer = new QTimer(this);
+        connect(timer, SIGNAL(timeout()), this, SIGNAL(timeout()));
+    }
+}
+
+void SimulationTimer::setInterval(int msec)
+{
+    interval = msec;
+    if (timer != nullptr)
+    {
+        timer->setInterval(msec);
+    }
+}
+
+bool SimulationTimer::isActive() const
+{
+    if (timer != nullptr)
+    {
+        return timer->isActive();
+    }
+    return active;
+}
+
+void SimulationTimer::start()
+{
+    if (timer != nullptr)
+    {
+        timer->start();
+        return;
+    }
+
+    // restarting drops whatever was already scheduled, like QTimer does
+    active = true;
+    generation++;
+    scheduleNext();
+}
+
+void SimulationTimer::stop()
+{
+    if (timer != nullptr)
+    {
+        timer->stop();
+        return;
+    }
+
+    active = false;
+    generation++;
+}
+
+void SimulationTimer::scheduleNext()
+{
+    // the timer may be deleted before its event comes up
+    QPointer<SimulationTimer> self(this);
+    quint64 scheduledGeneration = generation;
+    EventScheduler *owner = scheduler;
+    scheduler->schedule(interval, [self, scheduledGeneration, owner]() {
+        if (self.isNull())
+        {
+            owner->discardCurrent();
+            return;
+        }
+        self->fire(scheduledGeneration);
+    });
+}
+
+void SimulationTimer::fire(quint64 firedGeneration)
+{
+    // ignore events from before the last start or stop
+    if (!active || firedGeneration != generation)
+    {
+        scheduler->discardCurrent();
+        return;
+    }
+
+    emit timeout();
+
+    // repeat until stopped, unless a slot connected to timeout already stopped or restarted the timer
+    if (active && firedGeneration == generation)
+    {
+        scheduleNext();
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SIMULATIONTIMER_H
+#define SIMULATIONTIMER_H
+
+#include "EventScheduler.h"
+#include <QObject>
+#include <QTimer>
+
+// repeating timer with the same interface as QTimer.
+// without a scheduler it wraps a QTimer and fires in real time,
+// with a scheduler it fires on the virtual clock instead and needs no event loop.
+class SimulationTimer : public QObject
+{
+    Q_OBJECT
+private:
+    EventScheduler *scheduler;
+    QTimer *timer;
+    int interval;
+    bool active;
+    quint64 generation; // bumped on every start and stop so stale scheduled events are ignored
+
+    void scheduleNext();
+    void fire(quint64 firedGeneration);
+
+signals:
+    void timeout();
+
+public:
+    SimulationTimer(EventScheduler *scheduler, QObject *parent = nullptr);
+
+    void setInterval(int msec);
+
+    int getInterval() const { return interval; }
+
+    bool isActive() const;
+
+    void start();
+
+    void stop();
+};
+
+#endif // SIMULATIONTIMER_H
+
+// get uml format for this class like this:
+
+// -scheduler: EventScheduler *
+// -timer: QTimer *
+// -interval: int
+// -active: bool
+// -generation: quint64
+
+// +setInterval(int)
+// +getInterval(): int
+// +isActive(): bool
+// +start()
+// +stop()
+// +timeout()
+// -scheduleNext()
+// -fire(quint64)
@@ -0,0 +1,171 @@
+#include "SystemLogModel.h"
+#include <QStringList>
+
+SystemLogModel::SystemLogModel(int maxLines, QObject *parent) : QAbstractListModel(parent), maxLines(maxLines)
+{
+    // hand new lines to the view about once per frame instead of once per event
+    batchTimer = new QTimer(this);
+    batchTimer->setSingleShot(true);
+    batchTimer->setInterval(16);
+    connect(batchTimer, &QTimer::timeout, this, &SystemLogModel::flush);
+}
+
+int SystemLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(rows.size());
+}
+
+QVariant SystemLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= int(rows.size()))
+    {
+        return QVariant();
+    }
+    const Line &line = lines[rows[index.row()] - firstLine];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return line.isMessage ? line.text : EventLog::format(line.event);
+    case Qt::ForegroundRole:
+        // building wide lines keep the default color
+        return line.event.elevatorId > 0 ? QVariant(elevatorColor(line.event.elevatorId)) : QVariant();
+    case elevatorRole:
+        return int(line.event.elevatorId);
+    }
+    return QVariant();
+}
+
+void SystemLogModel::addEvent(const LogEvent &event)
+{
+    Line line;
+    line.event = event;
+    line.isMessage = false;
+    add(line);
+}
+
+void SystemLogModel::addMessage(const QString &text, int elevatorId)
+{
+    // one row per line of text so every row has the same height
+    Line line;
+    line.event.time = 0;
+    line.event.floor = 0;
+    line.event.elevatorId = qint16(elevatorId);
+    line.isMessage = true;
+    for (const QString &part : text.split('\n'))
+    {
+        line.text = part;
+        add(line);
+    }
+}
+
+void SystemLogModel::add(const Line &line)
+{
+    // only the newest maxLines can ever be shown, so a flood between batches cannot grow without limit
+    if (pending.size() >= 2 * maxLines)
+    {
+        pending.remove(0, pending.size() - maxLines);
+    }
+    pending.push_back(line);
+    if (!batchTimer->isActive())
+    {
+        batchTimer->start();
+    }
+}
+
+bool SystemLogModel::isShown(const Line &line) const
+{
+    // building wide lines concern every car
+    return elevatorFilter == 0 || line.event.elevatorId == elevatorFilter || line.event.elevatorId <= 0;
+}
+
+void SystemLogModel::flush()
+{
+    if (pending.isEmpty())
+    {
+        return;
+    }
+
+    // lines that would be pushed straight out again are never stored
+    int skipped = qMax(0, pending.size() - maxLines);
+
+    // store the batch and note which of its lines pass the filter
+    QVector<quint64> added;
+    for (int i = skipped; i < pending.size(); i++)
+    {
+        quint64 number = firstLine + lines.size();
+        lines.push_back(pending[i]);
+        if (isShown(pending[i]))
+        {
+            added.push_back(number);
+        }
+    }
+    pending.clear();
+
+    // forget the oldest lines, the batch fits so only rows that were already shown can go
+    while (int(lines.size()) > maxLines)
+    {
+        lines.pop_front();
+        firstLine++;
+    }
+    int removed = 0;
+    while (removed < int(rows.size()) && rows[removed] < firstLine)
+    {
+        removed++;
+    }
+    if (removed > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, removed - 1);
+        rows.erase(rows.begin(), rows.begin() + removed);
+        endRemoveRows();
+    }
+
+    if (!added.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), int(rows.size()), int(rows.size()) + added.size() - 1);
+        rows.insert(rows.end(), added.begin(), added.end());
+        endInsertRows();
+    }
+}
+
+void SystemLogModel::setElevatorFilter(int elevatorId)
+{
+    flush();
+    beginResetModel();
+    elevatorFilter = elevatorId;
+    rows.clear();
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        if (isShown(lines[i]))
+        {
+            rows.push_back(firstLine + i);
+        }
+    }
+    endResetModel();
+}
+
+void SystemLogModel::clear()
+{
+    beginResetModel();
+    pending.clear();
+    firstLine += lines.size();
+    lines.clear();
+    rows.clear();
+    endResetModel();
+}
+
+QColor SystemLogModel::elevatorColor(int elevatorId)
+{
+    // the first three cars keep their familiar colors
+    switch (elevatorId)
+    {
+    case 1:
+        return QColor(0, 192, 255);
+    case 2:
+        return QColor(0, 64, 255);
+    case 3:
+        return QColor(0, 192, 0);
+    }
+
+    // step round the color wheel by the golden angle so neighbouring cars never look alike
+    return QColor::fromHsv((elevatorId - 4) * 137 % 360, 255, 200);
+}
@@ -0,0 +1,85 @@
+#ifndef SYSTEMLOGMODEL_H
+#define SYSTEMLOGMODEL_H
+
+#include "EventLog.h"
+#include <QAbstractListModel>
+#include <QColor>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <deque>
+
+// list model behind the system log view.
+// new lines are collected and handed to the view in one batch per frame, at most maxLines lines are
+// kept, and control system events are only turned into text when the view asks for a visible row.
+class SystemLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+private:
+    struct Line
+    {
+        LogEvent event; // control system event, or just the car for a message
+        QString text;   // used instead of the event when isMessage is set
+        bool isMessage;
+    };
+
+    std::deque<Line> lines;   // oldest first
+    quint64 firstLine = 0;    // number of lines.front(), lines are numbered in the order they were added
+    std::deque<quint64> rows; // numbers of the lines shown with the current filter
+    QVector<Line> pending;    // lines waiting for the next batch
+    int maxLines;
+    int elevatorFilter = 0;   // 0 shows every car
+    QTimer *batchTimer;
+
+    void add(const Line &line);
+
+    bool isShown(const Line &line) const;
+
+private slots:
+    void flush();
+
+public:
+    enum roles
+    {
+        elevatorRole = Qt::UserRole + 1
+    };
+
+    SystemLogModel(int maxLines = 20000, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void addEvent(const LogEvent &event);
+
+    void addMessage(const QString &text, int elevatorId);
+
+    void setElevatorFilter(int elevatorId);
+
+    void clear();
+
+    static QColor elevatorColor(int elevatorId);
+};
+
+#endif // SYSTEMLOGMODEL_H
+
+// get uml format for this class like this:
+
+// -lines: deque<Line>
+// -firstLine: quint64
+// -rows: deque<quint64>
+// -pending: QVector<Line>
+// -maxLines: int
+// -elevatorFilter: int
+// -batchTimer: QTimer *
+
+// +rowCount(const QModelIndex &): int
+// +data(const QModelIndex &, int): QVariant
+// +addEvent(const LogEvent &)
+// +addMessage(const QString &, int)
+// +setElevatorFilter(int)
+// +clear()
+// +elevatorColor(int): QColor
+// -add(const Line &)
+// -isShown(const Line &): bool
+// -flush()
@@ -0,0 +1,165 @@
+#include "TraceRecorder.h"
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace
+{
+struct TraceEvent
+{
+    const char *name;
+    qint64 time;
+    qint64 value; // duration of a scope, or the counter's value
+    bool counter;
+};
+
+struct ThreadBuffer
+{
+    int thread;
+    quint64 dropped = 0;
+    std::vector<TraceEvent> events;
+};
+
+// about a hundred megabytes per thread, a long run keeps its beginning
+const size_t maxEvents = 1 << 22;
+
+QMutex buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+qint64 startTime = 0;
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+ThreadBuffer *buffer()
+{
+    // buffers outlive their threads, so a saved trace still has the runs of a finished sweep
+    if (threadBuffer == nullptr)
+    {
+        QMutexLocker locker(&buffersMutex);
+        buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer));
+        threadBuffer = buffers.back().get();
+        threadBuffer->thread = int(buffers.size());
+    }
+    return threadBuffer;
+}
+
+void record(const TraceEvent &event)
+{
+    ThreadBuffer *b = buffer();
+    if (b->events.size() == maxEvents)
+    {
+        b->dropped++;
+        return;
+    }
+    b->events.push_back(event);
+}
+
+// microseconds since recording started, the unit trace viewers expect
+QString microseconds(qint64 ns)
+{
+    return QString::number((ns - startTime) / 1000.0, 'f', 3);
+}
+}
+
+std::atomic<bool> TraceRecorder::recording(false);
+
+void TraceRecorder::complete(const char *name, qint64 startNs, qint64 endNs)
+{
+    record({name, startNs, endNs - startNs, false});
+}
+
+void TraceRecorder::counter(const char *name, qint64 value)
+{
+    record({name, now(), value, true});
+}
+
+qint64 TraceRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TraceRecorder::isCompiledIn()
+{
+#ifdef ELEVATOR_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TraceRecorder::start()
+{
+    QMutexLocker locker(&buffersMutex);
+    for (const std::unique_ptr<ThreadBuffer> &b : buffers)
+    {
+        b->events.clear();
+        b->dropped = 0;
+    }
+    startTime = now();
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop()
+{
+    recording.store(false, std::memory_order_relaxed);
+}
+
+quint64 TraceRecorder::getDropped()
+{
+    QMutexLocker locker(&buffersMutex);
+    quint64 dropped = 0;
+    for (const std::unique_ptr<ThreadBuffer> &b : buffers)
+    {
+        dropped += b->dropped;
+    }
+    return dropped;
+}
+
+bool TraceRecorder::save(const QString &fileName, QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+
+    // complete events for scopes, counter events for counters, one viewer track per thread
+    QMutexLocker locker(&buffersMutex);
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer> &b : buffers)
+    {
+        if (b->events.empty())
+        {
+            continue;
+        }
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->thread << ",\"args\":{\"name\":\"thread " << b->thread << "\"}}";
+        first = false;
+        for (const TraceEvent &event : b->events)
+        {
+            if (event.counter)
+            {
+                out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << b->thread << ",\"ts\":" << microseconds(event.time)
+                    << ",\"args\":{\"value\":" << event.value << "}}";
+            }
+            else
+            {
+                out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->thread << ",\"ts\":" << microseconds(event.time)
+                    << ",\"dur\":" << QString::number(event.value / 1000.0, 'f', 3) << "}";
+            }
+        }
+    }
+    out << "\n]}\n";
+
+    out.flush();
+    if (file.error() != QFileDevice::NoError)
+    {
+        error = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
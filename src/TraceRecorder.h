@@ -0,0 +1,101 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// timed scopes and counters inside the engine, saved in the chrome trace event format so a run
+// can be opened in a trace viewer such as perfetto or chrome://tracing.
+// the TRACE_ macros are only compiled in when ELEVATOR_TRACING is defined (qmake CONFIG+=tracing),
+// otherwise they are empty and cost nothing. compiled in, a scope costs one flag check while
+// nothing is being recorded and two clock reads while it is.
+// every thread records into its own buffer. start, stop and save between runs, not during one
+class TraceRecorder
+{
+private:
+    static std::atomic<bool> recording;
+
+public:
+    // names have to be string literals, only the pointer is kept
+    static void complete(const char *name, qint64 startNs, qint64 endNs);
+
+    static void counter(const char *name, qint64 value);
+
+    // nanoseconds on a steady clock
+    static qint64 now();
+
+    static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+
+    // whether the TRACE_ macros were compiled in, without them nothing gets recorded
+    static bool isCompiledIn();
+
+    // drops anything recorded before
+    static void start();
+
+    static void stop();
+
+    // events dropped because a thread's buffer was full
+    static quint64 getDropped();
+
+    static bool save(const QString &fileName, QString &error);
+};
+
+// records the time from its construction to the end of the enclosing block
+class TraceScope
+{
+private:
+    const char *name;
+    qint64 startNs;
+
+public:
+    explicit TraceScope(const char *name) : name(name), startNs(TraceRecorder::isRecording() ? TraceRecorder::now() : -1) {}
+
+    ~TraceScope()
+    {
+        if (startNs != -1)
+        {
+            TraceRecorder::complete(name, startNs, TraceRecorder::now());
+        }
+    }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef ELEVATOR_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_COUNTER(name, value)                 \
+    do                                             \
+    {                                              \
+        if (TraceRecorder::isRecording())          \
+        {                                          \
+            TraceRecorder::counter(name, (value)); \
+        }                                          \
+    } while (0)
+#else
+#define TRACE_SCOPE(name) \
+    do                    \
+    {                     \
+    } while (0)
+#define TRACE_COUNTER(name, value) \
+    do                             \
+    {                              \
+    } while (0)
+#endif
+
+#endif // TRACERECORDER_H
+
+// get uml format for this class like this:
+
+// -recording: std::atomic<bool>
+
+// +complete(const char *, qint64, qint64)
+// +counter(const char *, qint64)
+// +now(): qint64
+// +isRecording(): bool
+// +isCompiledIn(): bool
+// +start()
+// +stop()
+// +getDropped(): quint64
+// +save(const QString &, QString &): bool
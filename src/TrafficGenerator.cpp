@@ -0,0 +1,136 @@
+#include "TrafficGenerator.h"
+
+TrafficGenerator::TrafficGenerator(int numFloors, const QString &profileName, double arrivalsPerMinute, quint32 seed) : rng(seed), numFloors(numFloors), arrivalsPerMinute(arrivalsPerMinute), currentTime(0)
+{
+    // unknown names fall back to uniform traffic
+    trafficProfile = profile::uniform;
+    if (profileName == "up-peak")
+    {
+        trafficProfile = profile::upPeak;
+    }
+    else if (profileName == "down-peak")
+    {
+        trafficProfile = profile::downPeak;
+    }
+    else if (profileName == "lunch")
+    {
+        trafficProfile = profile::lunch;
+    }
+    else if (profileName == "inter-floor")
+    {
+        trafficProfile = profile::interFloor;
+    }
+}
+
+QStringList TrafficGenerator::profiles()
+{
+    return QStringList() << "uniform" << "up-peak" << "down-peak" << "lunch" << "inter-floor";
+}
+
+PassengerArrival TrafficGenerator::next()
+{
+    // poisson arrivals, the gap between passengers is exponentially distributed
+    std::exponential_distribution<double> gapDistribution(arrivalsPerMinute / 60000.0);
+    currentTime += qint64(gapDistribution(rng));
+
+    PassengerArrival arrival;
+    arrival.time = currentTime;
+
+    // pick the kind of trip, the split follows the usual traffic analysis mixes
+    std::uniform_real_distribution<double> mix(0.0, 1.0);
+    double roll = mix(rng);
+    switch (trafficProfile)
+    {
+    case profile::upPeak:
+        // 85% up from the lobby, 10% between floors, 5% down to the lobby
+        if (roll < 0.85)
+        {
+            tripFromLobby(arrival);
+        }
+        else if (roll < 0.95)
+        {
+            tripBetweenFloors(arrival);
+        }
+        else
+        {
+            tripToLobby(arrival);
+        }
+        break;
+    case profile::downPeak:
+        // 85% down to the lobby, 10% between floors, 5% up from the lobby
+        if (roll < 0.85)
+        {
+            tripToLobby(arrival);
+        }
+        else if (roll < 0.95)
+        {
+            tripBetweenFloors(arrival);
+        }
+        else
+        {
+            tripFromLobby(arrival);
+        }
+        break;
+    case profile::lunch:
+        // 45% out to the lobby, 45% back up from it, 10% between floors
+        if (roll < 0.45)
+        {
+            tripToLobby(arrival);
+        }
+        else if (roll < 0.9)
+        {
+            tripFromLobby(arrival);
+        }
+        else
+        {
+            tripBetweenFloors(arrival);
+        }
+        break;
+    case profile::interFloor:
+        tripBetweenFloors(arrival);
+        break;
+    default:
+        arrival.origin = randomFloor(1, numFloors);
+        arrival.destination = randomFloorExcept(1, numFloors, arrival.origin);
+        break;
+    }
+    return arrival;
+}
+
+int TrafficGenerator::randomFloor(int lowest, int highest)
+{
+    std::uniform_int_distribution<int> floorDistribution(lowest, highest);
+    return floorDistribution(rng);
+}
+
+int TrafficGenerator::randomFloorExcept(int lowest, int highest, int excluded)
+{
+    // draw from one floor less and skip over the excluded one, so there is no retry loop
+    int floor = randomFloor(lowest, highest - 1);
+    return floor >= excluded ? floor + 1 : floor;
+}
+
+void TrafficGenerator::tripFromLobby(PassengerArrival &arrival)
+{
+    arrival.origin = lobby;
+    arrival.destination = randomFloor(lobby + 1, numFloors);
+}
+
+void TrafficGenerator::tripToLobby(PassengerArrival &arrival)
+{
+    arrival.origin = randomFloor(lobby + 1, numFloors);
+    arrival.destination = lobby;
+}
+
+void TrafficGenerator::tripBetweenFloors(PassengerArrival &arrival)
+{
+    // a building with a single floor above the lobby has no trips between upper floors
+    if (numFloors - lobby < 2)
+    {
+        arrival.origin = randomFloor(1, numFloors);
+        arrival.destination = randomFloorExcept(1, numFloors, arrival.origin);
+        return;
+    }
+    arrival.origin = randomFloor(lobby + 1, numFloors);
+    arrival.destination = randomFloorExcept(lobby + 1, numFloors, arrival.origin);
+}
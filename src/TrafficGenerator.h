@@ -0,0 +1,74 @@
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <random>
+
+// one passenger turning up at a floor, wanting to go to another floor
+struct PassengerArrival
+{
+    qint64 time; // milliseconds since the start of the run
+    int origin;
+    int destination;
+};
+
+// seeded passenger arrivals for the standard building traffic patterns.
+// arrivals are a poisson process and the same seed always gives the same passengers.
+//   uniform      any floor to any other floor
+//   up-peak      morning rush, mostly from the lobby to the floors above
+//   down-peak    evening rush, mostly from the floors above to the lobby
+//   lunch        to and from the lobby in equal measure, with some trips between floors
+//   inter-floor  trips between the floors above the lobby
+class TrafficGenerator
+{
+private:
+    enum class profile
+    {
+        uniform,
+        upPeak,
+        downPeak,
+        lunch,
+        interFloor
+    };
+
+    std::mt19937 rng;
+    profile trafficProfile;
+    int numFloors;
+    double arrivalsPerMinute;
+    qint64 currentTime;
+
+    static const int lobby = 1;
+
+    int randomFloor(int lowest, int highest);
+    int randomFloorExcept(int lowest, int highest, int excluded);
+    void tripFromLobby(PassengerArrival &arrival);
+    void tripToLobby(PassengerArrival &arrival);
+    void tripBetweenFloors(PassengerArrival &arrival);
+
+public:
+    TrafficGenerator(int numFloors, const QString &profileName, double arrivalsPerMinute, quint32 seed);
+
+    static QStringList profiles();
+
+    PassengerArrival next();
+};
+
+#endif // TRAFFICGENERATOR_H
+
+// get uml format for this class like this:
+
+// -rng: mt19937
+// -trafficProfile: profile
+// -numFloors: int
+// -arrivalsPerMinute: double
+// -currentTime: qint64
+
+// +profiles(): QStringList
+// +next(): PassengerArrival
+// -randomFloor(int, int): int
+// -randomFloorExcept(int, int, int): int
+// -tripFromLobby(PassengerArrival &)
+// -tripToLobby(PassengerArrival &)
+// -tripBetweenFloors(PassengerArrival &)
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Headless command line runner for the elevator simulation
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = ElevatorBatch
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../ElevatorCore.pri)
+
+SOURCES += \
+        main.cpp \
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
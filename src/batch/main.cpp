@@ -0,0 +1,506 @@
+#include "SessionLog.h"
+#include "SimulationRunner.h"
+#include "SimulationSweep.h"
+#include "TraceRecorder.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QTextStream>
+
+static int fail(const QString &message)
+{
+    QTextStream(stderr) << "ElevatorBatch: " << message << "\n";
+    return 1;
+}
+
+// times are recorded in milliseconds and reported in seconds
+static QString describeTimes(const Histogram &times)
+{
+    return QString("average %1 s, p50 %2 s, p90 %3 s, p99 %4 s, max %5 s")
+        .arg(times.mean() / 1000.0)
+        .arg(times.percentile(50) / 1000.0)
+        .arg(times.percentile(90) / 1000.0)
+        .arg(times.percentile(99) / 1000.0)
+        .arg(times.max() / 1000.0);
+}
+
+// sixteen hex digits, so digests line up when compared
+static QString describeDigest(quint64 digest)
+{
+    return QString::number(digest, 16).rightJustified(16, '0');
+}
+
+static QString csvTimes(const Histogram &times)
+{
+    return QString("%1,%2,%3,%4,%5")
+        .arg(times.mean() / 1000.0)
+        .arg(times.percentile(50) / 1000.0)
+        .arg(times.percentile(90) / 1000.0)
+        .arg(times.percentile(99) / 1000.0)
+        .arg(times.max() / 1000.0);
+}
+
+// counts like "4", "2,4,8" or "10-40:10", every value at least minimum
+static bool parseCounts(const QString &text, int minimum, QVector<int> &values)
+{
+    for (const QString &part : text.split(','))
+    {
+        bool ok = true;
+        QString range = part.section(':', 0, 0);
+        int dash = range.indexOf('-', 1);
+        if (dash == -1)
+        {
+            values.push_back(part.toInt(&ok));
+        }
+        else
+        {
+            // a range with an optional step
+            int low = range.left(dash).toInt(&ok);
+            int high = ok ? range.mid(dash + 1).toInt(&ok) : 0;
+            int step = ok && part.contains(':') ? part.section(':', 1).toInt(&ok) : 1;
+            if (!ok || step < 1 || low < minimum || high < low)
+            {
+                return false;
+            }
+            for (int value = low; value <= high; value += step)
+            {
+                values.push_back(value);
+            }
+        }
+        if (!ok || values.last() < minimum)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// positive seconds like "3" or "2.5,3,4", stored as milliseconds
+static bool parseSeconds(const QString &text, QVector<int> &values)
+{
+    for (const QString &part : text.split(','))
+    {
+        bool ok = true;
+        double seconds = part.toDouble(&ok);
+        if (!ok || seconds <= 0)
+        {
+            return false;
+        }
+        values.push_back(int(seconds * 1000));
+    }
+    return true;
+}
+
+// nothing to do without a file
+static void startTracing(const QString &fileName)
+{
+    if (!fileName.isEmpty())
+    {
+        TraceRecorder::start();
+    }
+}
+
+static bool saveTracing(const QString &fileName, QString &error)
+{
+    if (fileName.isEmpty())
+    {
+        return true;
+    }
+    TraceRecorder::stop();
+    if (TraceRecorder::getDropped() > 0)
+    {
+        QTextStream(stderr) << "ElevatorBatch: " << TraceRecorder::getDropped() << " trace events did not fit and were dropped.\n";
+    }
+    return TraceRecorder::save(fileName, error);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("ElevatorBatch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the elevator simulation headless and prints throughput and latency statistics.\n"
+                                     "Floors, elevators, strategies and timings take comma separated lists, counts also take ranges like 10-40:10.\n"
+                                     "Every combination is simulated in parallel and the runs of each combination are combined.");
+    parser.addHelpOption();
+
+    QCommandLineOption floorsOption(QStringList() << "f" << "floors", "Number of floors in the building.", "counts", "10");
+    QCommandLineOption elevatorsOption(QStringList() << "e" << "elevators", "Number of elevator cars.", "counts", "3");
+    QCommandLineOption groupsOption(QStringList() << "g" << "groups", "Car groups as name:cars:floors separated by semicolons, like low:8:1-20;high:8:1,21-40. Each group has its own controller and serves only its own floors, passengers change groups at floors they share. Replaces --floors and --elevators.", "groups");
+    QCommandLineOption trafficOption(QStringList() << "t" << "traffic", "Traffic profile: " + TrafficGenerator::profiles().join(", ") + ".", "profile", "uniform");
+    QCommandLineOption traceOption("trace", "Play hall and car calls from a controller log instead of generated traffic. Lines are time in ms,hall,floor,up|down or time in ms,car,floor,car. Without --duration the whole log is played.", "file");
+    QCommandLineOption strategyOption(QStringList() << "a" << "strategy", "Dispatch strategies: " + DispatchStrategyRegistry::instance().names().join(", ") + ", or all to compare them on the same traffic.", "names", "closest");
+    QCommandLineOption destinationOption("destination-dispatch", "Riders enter their floor at a kiosk in the hall and are told which car to take, so riders going to the same floors share cars. Replaces --strategy for hall calls.");
+    QCommandLineOption orderingOption(QStringList() << "o" << "ordering", "Car stop ordering: look or fifo.", "ordering", "look");
+    QCommandLineOption rateOption(QStringList() << "r" << "rate", "Passenger arrivals per minute.", "rate", "10");
+    QCommandLineOption durationOption(QStringList() << "d" << "duration", "Simulated duration in seconds.", "seconds", "3600");
+    QCommandLineOption moveTimeOption("move-time", "Seconds for a car to travel one floor.", "seconds", "3");
+    QCommandLineOption doorTimeOption("door-time", "Seconds a car's door stays open.", "seconds", "10");
+    QCommandLineOption speedOption("speed", "Rated car speed in m/s. Cars then fly between stops on an acceleration and jerk limited curve instead of taking move-time per floor.", "m/s", "0");
+    QCommandLineOption accelerationOption("acceleration", "Rated car acceleration in m/s^2, used with --speed.", "m/s^2", "1.0");
+    QCommandLineOption jerkOption("jerk", "Rated car jerk in m/s^3, used with --speed.", "m/s^3", "1.5");
+    QCommandLineOption floorHeightOption("floor-height", "Metres from one floor to the next, used with --speed.", "metres", "3.5");
+    QCommandLineOption capacityOption("capacity", "Riders that fit in a car, 0 for no limit.", "riders", "0");
+    QCommandLineOption passengerTimeOption("passenger-time", "Seconds each rider getting on or off keeps the door open longer.", "seconds", "0");
+    QCommandLineOption reassignOption("reassign", "Seconds between reassignments of open hall calls to the best cars, 0 to keep the first choice.", "seconds", "0");
+    QCommandLineOption seedOption(QStringList() << "s" << "seed", "Random seed for starting floors and traffic.", "seed", "1");
+    QCommandLineOption runsOption(QStringList() << "n" << "runs", "Runs per combination, with seeds counting up from --seed.", "count", "1");
+    QCommandLineOption threadsOption(QStringList() << "j" << "threads", "Simulations to run at once, 0 for one per core.", "count", "0");
+    QCommandLineOption replayOption("replay", "Play back a session recorded by the GUI with --record instead of simulating passengers. The same session always gives the same events.", "file");
+    QCommandLineOption csvOption("csv", "Print a header and one comma separated line per combination instead of a report.");
+    QCommandLineOption traceEventsOption("trace-events", "Save timed scopes inside the engine to this file in the chrome trace event format. Needs a build with CONFIG+=tracing.", "file");
+    QCommandLineOption verboseOption(QStringList() << "v" << "verbose", "Keep the control system's debug output.");
+    parser.addOption(floorsOption);
+    parser.addOption(elevatorsOption);
+    parser.addOption(groupsOption);
+    parser.addOption(trafficOption);
+    parser.addOption(traceOption);
+    parser.addOption(strategyOption);
+    parser.addOption(destinationOption);
+    parser.addOption(orderingOption);
+    parser.addOption(rateOption);
+    parser.addOption(durationOption);
+    parser.addOption(moveTimeOption);
+    parser.addOption(doorTimeOption);
+    parser.addOption(speedOption);
+    parser.addOption(accelerationOption);
+    parser.addOption(jerkOption);
+    parser.addOption(floorHeightOption);
+    parser.addOption(capacityOption);
+    parser.addOption(passengerTimeOption);
+    parser.addOption(reassignOption);
+    parser.addOption(seedOption);
+    parser.addOption(runsOption);
+    parser.addOption(threadsOption);
+    parser.addOption(replayOption);
+    parser.addOption(csvOption);
+    parser.addOption(traceEventsOption);
+    parser.addOption(verboseOption);
+    parser.process(a);
+
+    // the control system reports every dispatch decision, which drowns the statistics
+    if (!parser.isSet(verboseOption))
+    {
+        QLoggingCategory::setFilterRules("default.info=false");
+    }
+
+    QString traceEventsFile = parser.value(traceEventsOption);
+    if (!traceEventsFile.isEmpty() && !TraceRecorder::isCompiledIn())
+    {
+        return fail("trace-events needs a build with CONFIG+=tracing.");
+    }
+
+    // a recorded session carries its own building, so the other options do not apply
+    if (parser.isSet(replayOption))
+    {
+        SessionLog session;
+        QString error;
+        if (!session.load(parser.value(replayOption), error))
+        {
+            return fail(error);
+        }
+        startTracing(traceEventsFile);
+        SimulationResult result = SimulationRunner::replay(session);
+        if (!saveTracing(traceEventsFile, error))
+        {
+            return fail(error);
+        }
+        const SimulationConfig &sessionConfig = session.getConfig();
+        QTextStream out(stdout);
+        out << "Session: " << parser.value(replayOption) << ", " << session.getCommands().size() << " commands\n";
+        out << "Building: " << sessionConfig.numFloors << " floors, " << sessionConfig.numElevators << " elevators, " << sessionConfig.strategy << " strategy\n";
+        out << "Seed: " << sessionConfig.seed << "\n";
+        out << "Simulated " << result.simulatedTime / 1000.0 << " s in " << result.wallTime << " ms wall time (" << result.events << " events)\n";
+        out << "Event digest: " << describeDigest(result.eventDigest) << "\n";
+        out << "Hall call response: " << describeTimes(result.hallCallTimes) << "\n";
+        out << "Car utilisation: " << result.utilisation * 100 << "%\n";
+        return 0;
+    }
+
+    SimulationConfig config;
+    bool ok = true;
+    QVector<int> floors;
+    if (!parseCounts(parser.value(floorsOption), 2, floors))
+    {
+        return fail("floors must be numbers or ranges of at least 2.");
+    }
+    QVector<int> elevators;
+    if (!parseCounts(parser.value(elevatorsOption), 1, elevators))
+    {
+        return fail("elevators must be numbers or ranges of at least 1.");
+    }
+    if (parser.isSet(groupsOption))
+    {
+        // the groups fix the building, so there is one size to simulate
+        BuildingLayout layout;
+        QString error;
+        if (!layout.parse(parser.value(groupsOption), error))
+        {
+            return fail(error);
+        }
+        if (parser.isSet(traceOption))
+        {
+            return fail("call logs name cars building wide, so they cannot be played on car groups.");
+        }
+        config.groups = parser.value(groupsOption);
+        floors = QVector<int>() << layout.getNumFloors();
+        elevators = QVector<int>() << layout.getNumElevators();
+    }
+    config.traffic = parser.value(trafficOption);
+    config.destinationDispatch = parser.isSet(destinationOption);
+    if (!TrafficGenerator::profiles().contains(config.traffic))
+    {
+        return fail("unknown traffic profile " + config.traffic + ".");
+    }
+    QStringList strategies = DispatchStrategyRegistry::instance().names();
+    if (parser.value(strategyOption) != "all")
+    {
+        QStringList chosen = parser.value(strategyOption).split(',');
+        for (const QString &strategy : chosen)
+        {
+            if (!strategies.contains(strategy))
+            {
+                return fail("unknown dispatch strategy " + strategy + ".");
+            }
+        }
+        strategies = chosen;
+    }
+    if (parser.value(orderingOption) == "look")
+    {
+        config.ordering = queueOrdering::look;
+    }
+    else if (parser.value(orderingOption) == "fifo")
+    {
+        config.ordering = queueOrdering::fifo;
+    }
+    else
+    {
+        return fail("ordering must be look or fifo.");
+    }
+    config.arrivalsPerMinute = parser.value(rateOption).toDouble(&ok);
+    if (!ok || config.arrivalsPerMinute <= 0)
+    {
+        return fail("rate must be a positive number.");
+    }
+    double seconds = parser.value(durationOption).toDouble(&ok);
+    if (!ok || seconds <= 0)
+    {
+        return fail("duration must be a positive number of seconds.");
+    }
+    config.duration = qint64(seconds * 1000);
+    if (parser.isSet(traceOption))
+    {
+        // every run streams the file itself, this only checks it can be read
+        config.trace = parser.value(traceOption);
+        CallTrace trace(1, 1);
+        QString error;
+        if (!trace.open(config.trace, error))
+        {
+            return fail(error);
+        }
+        if (!parser.isSet(durationOption))
+        {
+            config.duration = 0;
+        }
+    }
+    QVector<int> moveTimes;
+    if (!parseSeconds(parser.value(moveTimeOption), moveTimes))
+    {
+        return fail("move-time must be positive numbers of seconds.");
+    }
+    QVector<int> doorTimes;
+    if (!parseSeconds(parser.value(doorTimeOption), doorTimes))
+    {
+        return fail("door-time must be positive numbers of seconds.");
+    }
+    config.speed = parser.value(speedOption).toDouble(&ok);
+    if (!ok || config.speed < 0)
+    {
+        return fail("speed must be a non-negative number.");
+    }
+    config.acceleration = parser.value(accelerationOption).toDouble(&ok);
+    if (!ok || config.acceleration <= 0)
+    {
+        return fail("acceleration must be a positive number.");
+    }
+    config.jerk = parser.value(jerkOption).toDouble(&ok);
+    if (!ok || config.jerk <= 0)
+    {
+        return fail("jerk must be a positive number.");
+    }
+    config.floorHeight = parser.value(floorHeightOption).toDouble(&ok);
+    if (!ok || config.floorHeight <= 0)
+    {
+        return fail("floor-height must be a positive number.");
+    }
+    config.capacity = parser.value(capacityOption).toInt(&ok);
+    if (!ok || config.capacity < 0)
+    {
+        return fail("capacity must be a non-negative number.");
+    }
+    double passengerSeconds = parser.value(passengerTimeOption).toDouble(&ok);
+    if (!ok || passengerSeconds < 0)
+    {
+        return fail("passenger-time must be a non-negative number of seconds.");
+    }
+    config.passengerTime = int(passengerSeconds * 1000);
+    double reassignSeconds = parser.value(reassignOption).toDouble(&ok);
+    if (!ok || reassignSeconds < 0)
+    {
+        return fail("reassign must be a non-negative number of seconds.");
+    }
+    config.reassignInterval = int(reassignSeconds * 1000);
+    quint32 firstSeed = parser.value(seedOption).toUInt(&ok);
+    if (!ok)
+    {
+        return fail("seed must be a non-negative number.");
+    }
+    int runs = parser.value(runsOption).toInt(&ok);
+    if (!ok || runs < 1)
+    {
+        return fail("runs must be a number of at least 1.");
+    }
+    int threads = parser.value(threadsOption).toInt(&ok);
+    if (!ok || threads < 0)
+    {
+        return fail("threads must be a non-negative number.");
+    }
+
+    // every combination, with the runs of one combination next to each other.
+    // every strategy sees exactly the same passengers because they share the seeds
+    SimulationSweep sweep(threads);
+    for (int floorCount : floors)
+    {
+        for (int elevatorCount : elevators)
+        {
+            for (const QString &strategy : strategies)
+            {
+                for (int moveTime : moveTimes)
+                {
+                    for (int doorTime : doorTimes)
+                    {
+                        for (int run = 0; run < runs; run++)
+                        {
+                            config.numFloors = floorCount;
+                            config.numElevators = elevatorCount;
+                            config.strategy = strategy;
+                            config.moveTime = moveTime;
+                            config.doorTime = doorTime;
+                            config.seed = firstSeed + quint32(run);
+                            sweep.add(config);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    startTracing(traceEventsFile);
+    QVector<SimulationResult> results = sweep.run();
+    QString error;
+    if (!saveTracing(traceEventsFile, error))
+    {
+        return fail(error);
+    }
+
+    QTextStream out(stdout);
+    if (parser.isSet(csvOption))
+    {
+        out << "floors,elevators,traffic,strategy,rate,move_time,speed,acceleration,jerk,floor_height,door_time,capacity,passenger_time,reassign,duration,first_seed,runs,arrived,boarded,delivered,throughput,"
+            << "wait_avg,wait_p50,wait_p90,wait_p99,wait_max,travel_avg,travel_p50,travel_p90,travel_p99,travel_max,"
+            << "journey_avg,journey_p50,journey_p90,journey_p99,journey_max,hall_call_avg,hall_call_p50,hall_call_p90,hall_call_p99,hall_call_max,"
+            << "hall_calls_waiting_avg,hall_calls_waiting_max,car_queue_avg,car_queue_max,car_load_avg,car_load_max,handling_capacity,utilisation,events,event_digest,wall_time\n";
+    }
+    for (int first = 0; first < results.size(); first += runs)
+    {
+        // combine the runs of one combination
+        const SimulationConfig &runConfig = sweep.at(first);
+        SimulationResult result = results[first];
+        for (int i = first + 1; i < first + runs; i++)
+        {
+            result.merge(results[i]);
+        }
+
+        double hours = result.simulatedTime / 3600000.0;
+        double throughput = hours > 0 ? result.passengersDelivered / hours : 0;
+        if (parser.isSet(csvOption))
+        {
+            out << runConfig.numFloors << "," << runConfig.numElevators << "," << (runConfig.trace.isEmpty() ? runConfig.traffic : "trace") << "," << (runConfig.destinationDispatch ? "destination" : runConfig.strategy) << ","
+                << runConfig.arrivalsPerMinute << "," << runConfig.moveTime / 1000.0 << "," << runConfig.speed << "," << runConfig.acceleration << ","
+                << runConfig.jerk << "," << runConfig.floorHeight << "," << runConfig.doorTime / 1000.0 << ","
+                << runConfig.capacity << "," << runConfig.passengerTime / 1000.0 << "," << runConfig.reassignInterval / 1000.0 << "," << runConfig.duration / 1000.0 << "," << runConfig.seed << "," << runs << "," << result.passengersArrived << ","
+                << result.passengersBoarded << "," << result.passengersDelivered << "," << throughput << "," << csvTimes(result.waitTimes) << ","
+                << csvTimes(result.travelTimes) << "," << csvTimes(result.journeyTimes) << "," << csvTimes(result.hallCallTimes) << ","
+                << result.hallCallBacklog.mean() << "," << result.hallCallBacklog.max() << "," << result.carQueueLengths.mean() << ","
+                << result.carQueueLengths.max() << "," << result.carLoads.mean() << "," << result.carLoads.max() << "," << result.handlingCapacity << ","
+                << result.utilisation << "," << result.events << "," << describeDigest(result.eventDigest) << "," << result.wallTime << "\n";
+            continue;
+        }
+
+        out << "Building: " << runConfig.numFloors << " floors, " << runConfig.numElevators << " elevators, ";
+        if (runConfig.trace.isEmpty())
+        {
+            out << runConfig.traffic << " traffic at " << runConfig.arrivalsPerMinute << " passengers/min\n";
+        }
+        else
+        {
+            out << "calls from " << runConfig.trace << "\n";
+        }
+        if (!runConfig.groups.isEmpty())
+        {
+            out << "Groups: " << runConfig.groups << "\n";
+        }
+        out << "Strategy: " << (runConfig.destinationDispatch ? "destination dispatch" : runConfig.strategy);
+        if (runConfig.speed > 0)
+        {
+            out << ", " << runConfig.speed << " m/s at " << runConfig.acceleration << " m/s^2 and " << runConfig.jerk << " m/s^3 over "
+                << runConfig.floorHeight << " m floors";
+        }
+        else
+        {
+            out << ", move " << runConfig.moveTime / 1000.0 << " s/floor";
+        }
+        out << ", door " << runConfig.doorTime / 1000.0 << " s";
+        if (runConfig.capacity > 0)
+        {
+            out << ", " << runConfig.capacity << " riders per car";
+        }
+        if (runConfig.passengerTime > 0)
+        {
+            out << ", " << runConfig.passengerTime / 1000.0 << " s per rider at the door";
+        }
+        if (runConfig.reassignInterval > 0)
+        {
+            out << ", reassigning every " << runConfig.reassignInterval / 1000.0 << " s";
+        }
+        out << "\n";
+        if (runs == 1)
+        {
+            out << "Seed: " << runConfig.seed << "\n";
+        }
+        else
+        {
+            out << "Seeds: " << runConfig.seed << " to " << runConfig.seed + quint32(runs - 1) << " (" << runs << " runs combined)\n";
+        }
+        out << "Simulated " << result.simulatedTime / 1000.0 << " s in " << result.wallTime << " ms wall time (" << result.events << " events)\n";
+        out << "Event digest: " << describeDigest(result.eventDigest) << "\n";
+        if (!runConfig.trace.isEmpty())
+        {
+            out << "Trace: " << result.traceCalls << " calls played, " << result.traceSkipped << " lines skipped\n";
+        }
+        out << "Passengers: " << result.passengersArrived << " arrived, " << result.passengersBoarded << " boarded, " << result.passengersDelivered << " delivered\n";
+        out << "Throughput: " << throughput << " passengers/hour\n";
+        out << "Handling capacity: " << result.handlingCapacity << " passengers in the busiest 5 minutes\n";
+        out << "Wait time: " << describeTimes(result.waitTimes) << "\n";
+        out << "Travel time: " << describeTimes(result.travelTimes) << "\n";
+        out << "Journey time: " << describeTimes(result.journeyTimes) << "\n";
+        out << "Hall call response: " << describeTimes(result.hallCallTimes) << "\n";
+        out << "Hall calls waiting: average " << result.hallCallBacklog.mean() << ", p99 " << result.hallCallBacklog.percentile(99) << ", max "
+            << result.hallCallBacklog.max() << "\n";
+        out << "Car queue length: average " << result.carQueueLengths.mean() << ", p99 " << result.carQueueLengths.percentile(99) << ", max "
+            << result.carQueueLengths.max() << "\n";
+        out << "Car load: average " << result.carLoads.mean() << ", p99 " << result.carLoads.percentile(99) << ", max " << result.carLoads.max() << "\n";
+        out << "Car utilisation: " << result.utilisation * 100 << "%\n\n";
+    }
+    return 0;
+}
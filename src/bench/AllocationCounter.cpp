@@ -0,0 +1,93 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<quint64> allocations(0);
+
+inline void counted()
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+}
+
+quint64 AllocationCounter::count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+bool AllocationCounter::countsMalloc()
+{
+    return true;
+}
+
+// glibc lets a program replace malloc, these hand every call straight on to glibc's own
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void __libc_free(void *pointer);
+
+    void *malloc(size_t size) noexcept
+    {
+        counted();
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size) noexcept
+    {
+        counted();
+        return __libc_calloc(count, size);
+    }
+
+    // a realloc counts as one allocation, whether or not the block had to move
+    void *realloc(void *pointer, size_t size) noexcept
+    {
+        counted();
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void *pointer) noexcept
+    {
+        __libc_free(pointer);
+    }
+}
+
+#else
+
+bool AllocationCounter::countsMalloc()
+{
+    return false;
+}
+
+void *operator new(std::size_t size)
+{
+    counted();
+    if (void *pointer = std::malloc(size != 0 ? size : 1))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// counts heap allocations made anywhere in the process, so benchmarks can report allocations per operation.
+// with glibc, malloc itself is wrapped, which also catches Qt containers since they allocate with malloc.
+// elsewhere only operator new is counted.
+class AllocationCounter
+{
+public:
+    static quint64 count();
+
+    // false when only operator new is counted
+    static bool countsMalloc();
+};
+
+#endif // ALLOCATIONCOUNTER_H
+
+// get uml format for this class like this:
+
+// +count(): quint64
+// +countsMalloc(): bool
@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# Microbenchmarks for the dispatch and stop ordering hot paths,
+# and end to end throughput scenarios
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = ElevatorBench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../ElevatorCore.pri)
+
+SOURCES += \
+        main.cpp \
+        AllocationCounter.cpp \
+        ScenarioBench.cpp \
+
+HEADERS += \
+        AllocationCounter.h \
+        ScenarioBench.h \
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,141 @@
+#include "ScenarioBench.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <chrono>
+
+QVector<Scenario> ScenarioBench::scenarios()
+{
+    QVector<Scenario> list;
+
+    // a few cars on a few floors through a working day, the defaults everywhere else
+    Scenario office;
+    office.name = "office";
+    office.config.numFloors = 10;
+    office.config.numElevators = 3;
+    office.config.traffic = "lunch";
+    office.config.arrivalsPerMinute = 6;
+    office.config.duration = 36000000;
+    office.config.seed = 1;
+    list.push_back(office);
+
+    // kinematic cars with a rider limit, dispatched on cost
+    Scenario tower;
+    tower.name = "tower";
+    tower.config.numFloors = 60;
+    tower.config.numElevators = 12;
+    tower.config.traffic = "up-peak";
+    tower.config.strategy = "cost";
+    tower.config.arrivalsPerMinute = 40;
+    tower.config.duration = 3600000;
+    tower.config.seed = 2;
+    tower.config.capacity = 16;
+    tower.config.passengerTime = 1000;
+    tower.config.speed = 6;
+    list.push_back(tower);
+
+    // one group of two hundred cars with open hall calls planned again every half minute
+    Scenario campus;
+    campus.name = "campus";
+    campus.config.numFloors = 40;
+    campus.config.numElevators = 200;
+    campus.config.traffic = "inter-floor";
+    campus.config.strategy = "cost";
+    campus.config.arrivalsPerMinute = 500;
+    campus.config.duration = 1800000;
+    campus.config.seed = 3;
+    campus.config.capacity = 20;
+    campus.config.passengerTime = 1000;
+    campus.config.reassignInterval = 30000;
+    list.push_back(campus);
+
+    return list;
+}
+
+ScenarioResult ScenarioBench::run(const Scenario &scenario, int repeats)
+{
+    // the same seed gives the same events every time, so the fastest repeat has the least noise
+    ScenarioResult best;
+    best.name = scenario.name;
+    for (int i = 0; i < repeats; i++)
+    {
+        SimulationRunner runner(scenario.config);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        SimulationResult result = runner.run();
+        qint64 wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || wallNs < best.wallNs)
+        {
+            best.simulatedTime = result.simulatedTime;
+            best.wallNs = qMax<qint64>(wallNs, 1);
+            best.events = result.events;
+            best.eventDigest = result.eventDigest;
+        }
+    }
+    return best;
+}
+
+bool ScenarioBench::save(const QVector<ScenarioResult> &results, const QString &fileName, QString &error)
+{
+    QJsonArray list;
+    for (const ScenarioResult &result : results)
+    {
+        QJsonObject object;
+        object["name"] = result.name;
+        object["simulated_seconds"] = result.simulatedTime / 1000.0;
+        object["wall_seconds"] = result.wallNs / 1e9;
+        object["events"] = double(result.events);
+        object["simulated_per_wall"] = result.simulatedPerWall();
+        object["events_per_second"] = result.eventsPerSecond();
+        object["event_digest"] = QString::number(result.eventDigest, 16).rightJustified(16, '0');
+        list.append(object);
+    }
+    QJsonObject root;
+    root["scenarios"] = list;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson()) == -1)
+    {
+        error = "cannot write " + fileName + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ScenarioBench::load(const QString &fileName, QVector<ScenarioResult> &results, QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = "cannot read " + fileName + ": " + file.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject())
+    {
+        error = fileName + ": not a saved scenario run.";
+        return false;
+    }
+
+    // only what the comparison needs, the rest of the file is for people
+    QJsonArray list = document.object().value("scenarios").toArray();
+    results.clear();
+    for (int i = 0; i < list.size(); i++)
+    {
+        QJsonObject object = list.at(i).toObject();
+        ScenarioResult result;
+        result.name = object.value("name").toString();
+        result.simulatedTime = qint64(object.value("simulated_seconds").toDouble() * 1000);
+        result.wallNs = qint64(object.value("wall_seconds").toDouble() * 1e9);
+        result.events = quint64(object.value("events").toDouble());
+        result.eventDigest = object.value("event_digest").toString().toULongLong(nullptr, 16);
+        if (result.name.isEmpty() || result.wallNs <= 0)
+        {
+            error = fileName + ": scenario " + QString::number(i + 1) + " has no name or wall time.";
+            return false;
+        }
+        results.push_back(result);
+    }
+    return true;
+}
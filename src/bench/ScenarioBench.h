@@ -0,0 +1,52 @@
+#ifndef SCENARIOBENCH_H
+#define SCENARIOBENCH_H
+
+#include "SimulationRunner.h"
+#include <QString>
+#include <QVector>
+
+// one fixed, seeded building run end to end through the control system and its cars
+struct Scenario
+{
+    QString name;
+    SimulationConfig config;
+};
+
+// how fast a scenario ran, from the fastest of its repeats
+struct ScenarioResult
+{
+    QString name;
+    qint64 simulatedTime = 0; // milliseconds
+    qint64 wallNs = 0;
+    quint64 events = 0;
+    quint64 eventDigest = 0;
+
+    double simulatedPerWall() const { return wallNs > 0 ? simulatedTime * 1e6 / wallNs : 0; }
+
+    double eventsPerSecond() const { return wallNs > 0 ? events * 1e9 / wallNs : 0; }
+};
+
+// end to end throughput of a small office, a sixty floor tower and a two hundred car campus.
+// results are saved as json, and a saved run can be given back as a baseline to catch a drop
+// in throughput. the scenarios are seeded, so a baseline with another event digest means the
+// engine's behaviour changed as well as its speed
+class ScenarioBench
+{
+public:
+    static QVector<Scenario> scenarios();
+
+    static ScenarioResult run(const Scenario &scenario, int repeats);
+
+    static bool save(const QVector<ScenarioResult> &results, const QString &fileName, QString &error);
+
+    static bool load(const QString &fileName, QVector<ScenarioResult> &results, QString &error);
+};
+
+#endif // SCENARIOBENCH_H
+
+// get uml format for this class like this:
+
+// +scenarios(): QVector<Scenario>
+// +run(const Scenario &, int): ScenarioResult
+// +save(const QVector<ScenarioResult> &, const QString &, QString &): bool
+// +load(const QString &, QVector<ScenarioResult> &, QString &): bool
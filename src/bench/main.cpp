@@ -0,0 +1,570 @@
+#include "AllocationCounter.h"
+#include "DestinationQueue.h"
+#include "DispatchCost.h"
+#include "ElevatorControlSystem.h"
+#include "ScenarioBench.h"
+#include "SimulationRunner.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <chrono>
+#include <functional>
+#include <random>
+
+// one building size to measure a benchmark at
+struct BenchCase
+{
+    int cars;
+    int floors;
+    int pending; // hall calls already waiting, or stops already queued
+    QString strategy;
+};
+
+struct Measurement
+{
+    double nsPerOp;
+    double allocationsPerOp;
+};
+
+// adds up time and allocations over timed batches of operations, setting up each batch is not counted.
+// batches that need a fresh building are short, so the cost of reading the clock is taken off each one,
+// and a case whose set up dwarfs the timed part stops after ten times the minimum time in all
+class Meter
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point createdTime;
+    Clock::time_point startTime;
+    quint64 startAllocations = 0;
+    qint64 elapsedNs = 0;
+    quint64 allocations = 0;
+    quint64 ops = 0;
+    qint64 minNs;
+
+    static qint64 nanoseconds(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    }
+
+    static qint64 clockCost()
+    {
+        // the fastest of many back to back reads
+        static qint64 cost = -1;
+        if (cost == -1)
+        {
+            cost = nanoseconds(Clock::now(), Clock::now());
+            for (int i = 0; i < 1000; i++)
+            {
+                cost = qMin(cost, nanoseconds(Clock::now(), Clock::now()));
+            }
+        }
+        return cost;
+    }
+
+public:
+    Meter(qint64 minMs) : createdTime(Clock::now()), minNs(minMs * 1000000) { clockCost(); }
+
+    bool done() const { return ops > 0 && (elapsedNs >= minNs || nanoseconds(createdTime, Clock::now()) >= 10 * minNs); }
+
+    void begin()
+    {
+        startAllocations = AllocationCounter::count();
+        startTime = Clock::now();
+    }
+
+    void end(quint64 batchOps)
+    {
+        Clock::time_point endTime = Clock::now();
+        allocations += AllocationCounter::count() - startAllocations;
+        elapsedNs += qMax<qint64>(0, nanoseconds(startTime, endTime) - clockCost());
+        ops += batchOps;
+    }
+
+    Measurement result() const { return {double(elapsedNs) / ops, double(allocations) / ops}; }
+};
+
+// never sends a car, so hall calls can be queued up while cars stand idle
+class HoldDispatch : public DispatchStrategy
+{
+public:
+    QString name() const override { return "hold"; }
+
+    int selectElevator(ElevatorControlSystem *, int, direction) override { return -1; }
+};
+
+// a building on the virtual clock with its cars spread evenly over the floors
+class Building
+{
+private:
+    EventScheduler scheduler;
+    QVector<ElevatorCar *> cars;
+
+public:
+    ElevatorControlSystem ecs;
+
+    Building(int numCars, int numFloors) : ecs(numCars, numFloors, &scheduler)
+    {
+        for (int i = 0; i < numCars; i++)
+        {
+            ElevatorCar *car = new ElevatorCar(i + 1, 1 + int(qint64(i) * numFloors / numCars), &ecs);
+            cars.push_back(car);
+            ecs.addElevator(car);
+        }
+    }
+
+    ~Building()
+    {
+        // the control system goes after its cars
+        for (ElevatorCar *car : cars)
+        {
+            delete car;
+        }
+    }
+
+    // open every car's door where it stands, so no car is idle or passing anywhere
+    void occupyCars()
+    {
+        for (int i = 1; i <= cars.size(); i++)
+        {
+            ecs.carRequest(i, ecs.getCarStates().floor(i));
+        }
+    }
+
+    // queue hall calls spread over the building without sending any car
+    void queueCalls(int count, const QString &strategy)
+    {
+        ecs.setDispatchStrategy(new HoldDispatch);
+        int calls = qMin(count, 2 * (ecs.getNumFloors() - 1));
+        for (int i = 0; i < calls; i++)
+        {
+            // up calls on the way up, then down calls on the way back
+            int upCalls = ecs.getNumFloors() - 1;
+            if (i < upCalls)
+            {
+                ecs.floorRequest(1 + int(qint64(i) * upCalls / qMin(calls, upCalls)), direction::up);
+            }
+            else
+            {
+                ecs.floorRequest(2 + int(qint64(i - upCalls) * upCalls / (calls - upCalls)), direction::down);
+            }
+        }
+        ecs.setDispatchStrategy(DispatchStrategyRegistry::instance().create(strategy));
+    }
+};
+
+// a hall call from every floor in turn that is not already waiting
+static void freeCalls(const HallCallTable &calls, int numFloors, QVector<QPair<int, direction>> &free)
+{
+    free.clear();
+    for (int floor = 1; floor <= numFloors; floor++)
+    {
+        if (floor < numFloors && !calls.contains(floor, direction::up))
+        {
+            free.push_back(qMakePair(floor, direction::up));
+        }
+        if (floor > 1 && !calls.contains(floor, direction::down))
+        {
+            free.push_back(qMakePair(floor, direction::down));
+        }
+    }
+}
+
+// hall calls placed while every car is busy, so each one is dispatched through the strategy
+// and either queued on a car or left waiting. a batch is the calls not already waiting
+static Measurement benchFloorRequest(const BenchCase &c, qint64 minMs)
+{
+    Meter meter(minMs);
+    QVector<QPair<int, direction>> calls;
+    while (!meter.done())
+    {
+        Building building(c.cars, c.floors);
+        building.occupyCars();
+        building.queueCalls(c.pending, c.strategy);
+        freeCalls(building.ecs.getFloorRequests(), c.floors, calls);
+        int batch = qMin(calls.size(), 64);
+
+        meter.begin();
+        for (int i = 0; i < batch; i++)
+        {
+            building.ecs.floorRequest(calls[i].first, calls[i].second);
+        }
+        meter.end(batch);
+    }
+    return meter.result();
+}
+
+// idle cars each picking up the waiting call nearest to them, a batch is one pickup per car
+static Measurement benchCheckFloorRequests(const BenchCase &c, qint64 minMs)
+{
+    Meter meter(minMs);
+    while (!meter.done())
+    {
+        Building building(c.cars, c.floors);
+        building.queueCalls(c.pending, c.strategy);
+
+        meter.begin();
+        for (int car = 1; car <= c.cars; car++)
+        {
+            building.ecs.checkFloorRequests(car);
+        }
+        meter.end(c.cars);
+    }
+    return meter.result();
+}
+
+// adding a stop and taking the next one from a car's queue of pending stops, in steady state
+static Measurement benchDestinationQueue(const BenchCase &c, qint64 minMs, queueOrdering ordering)
+{
+    DestinationQueue queue(c.floors, ordering);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> floorDistribution(1, c.floors);
+    int pending = qMin(c.pending, c.floors - 1);
+    while (queue.size() < pending)
+    {
+        queue.add(floorDistribution(rng));
+    }
+
+    // floors are drawn up front so the generator is not timed
+    QVector<int> floors(4096);
+    for (int &floor : floors)
+    {
+        floor = floorDistribution(rng);
+    }
+
+    Meter meter(minMs);
+    int current = 1;
+    direction travel = direction::up;
+    int checksum = 0;
+    while (!meter.done())
+    {
+        meter.begin();
+        for (int i = 0; i < floors.size(); i++)
+        {
+            queue.add(floors[i]);
+            if (queue.size() > pending)
+            {
+                int next = queue.take(current, travel);
+                travel = next >= current ? direction::up : direction::down;
+                current = next;
+                checksum += next;
+            }
+        }
+        meter.end(floors.size());
+    }
+    if (checksum == -1)
+    {
+        QTextStream(stderr) << checksum;
+    }
+    return meter.result();
+}
+
+// every car scored against a hall call in one pass over the car state table
+static Measurement benchDispatchCost(const BenchCase &c, qint64 minMs)
+{
+    Building building(c.cars, c.floors);
+    std::mt19937 rng(1);
+    for (int i = 1; i <= c.cars; i++)
+    {
+        // send some cars off so the table holds a mix of idle and moving cars
+        if (i % 3 != 0)
+        {
+            std::uniform_int_distribution<int> floorDistribution(1, c.floors);
+            building.ecs.carRequest(i, floorDistribution(rng));
+        }
+    }
+
+    DispatchCost cost(3);
+    QVector<int> costs(c.cars);
+    Meter meter(minMs);
+    int checksum = 0;
+    while (!meter.done())
+    {
+        meter.begin();
+        for (int floor = 1; floor <= c.floors; floor++)
+        {
+            checksum += cost.best(building.ecs.getCarStates(), floor, floor < c.floors ? direction::up : direction::down, costs.data());
+        }
+        meter.end(c.floors);
+    }
+    if (checksum == -1)
+    {
+        QTextStream(stderr) << checksum;
+    }
+    return meter.result();
+}
+
+// the whole simulation with passengers, one operation is one event taken off the scheduler
+static Measurement benchStep(const BenchCase &c, qint64 minMs)
+{
+    Meter meter(minMs);
+    quint32 seed = 1;
+    while (!meter.done())
+    {
+        SimulationConfig config;
+        config.numFloors = c.floors;
+        config.numElevators = c.cars;
+        config.strategy = c.strategy;
+        config.arrivalsPerMinute = 2.5 * c.cars;
+        config.duration = 600000;
+        config.seed = seed++;
+
+        SimulationRunner runner(config);
+        meter.begin();
+        SimulationResult result = runner.run();
+        meter.end(result.events);
+    }
+    return meter.result();
+}
+
+// the fixed scenarios end to end, compared with a saved baseline when one is given.
+// fails when either throughput falls more than threshold percent below the baseline
+static int runScenarios(const QString &filter, int repeats, const QString &jsonFile, const QString &baselineFile, double threshold)
+{
+    QTextStream out(stdout);
+    QString error;
+    QVector<ScenarioResult> baseline;
+    if (!baselineFile.isEmpty() && !ScenarioBench::load(baselineFile, baseline, error))
+    {
+        QTextStream(stderr) << "ElevatorBench: " << error << "\n";
+        return 1;
+    }
+
+    out << QString("%1 %2 %3 %4 %5\n").arg("scenario", -10).arg("events", 10).arg("sim s/wall s", 14).arg("events/s", 12).arg("vs baseline", 24);
+    QVector<ScenarioResult> results;
+    int regressions = 0;
+    for (const Scenario &scenario : ScenarioBench::scenarios())
+    {
+        if (!filter.isEmpty() && !scenario.name.contains(filter))
+        {
+            continue;
+        }
+        ScenarioResult result = ScenarioBench::run(scenario, repeats);
+        results.push_back(result);
+
+        QString comparison = baselineFile.isEmpty() ? QString() : "not in baseline";
+        for (const ScenarioResult &previous : baseline)
+        {
+            if (previous.name != result.name)
+            {
+                continue;
+            }
+            double simulatedChange = result.simulatedPerWall() / previous.simulatedPerWall() - 1;
+            double eventsChange = result.eventsPerSecond() / previous.eventsPerSecond() - 1;
+            bool slower = qMin(simulatedChange, eventsChange) * 100 < -threshold;
+            regressions += slower ? 1 : 0;
+            comparison = QString("%1% %2%").arg(simulatedChange * 100, 0, 'f', 1).arg(eventsChange * 100, 0, 'f', 1);
+            if (slower)
+            {
+                comparison += " SLOWER";
+            }
+            else if (previous.eventDigest != result.eventDigest)
+            {
+                // the engine does different work now, so the numbers are not like for like
+                comparison += " changed";
+            }
+        }
+        out << QString("%1 %2 %3 %4 %5\n")
+                   .arg(result.name, -10)
+                   .arg(result.events, 10)
+                   .arg(result.simulatedPerWall(), 14, 'f', 0)
+                   .arg(result.eventsPerSecond(), 12, 'f', 0)
+                   .arg(comparison, 24);
+        out.flush();
+    }
+
+    if (!jsonFile.isEmpty() && !ScenarioBench::save(results, jsonFile, error))
+    {
+        QTextStream(stderr) << "ElevatorBench: " << error << "\n";
+        return 1;
+    }
+    if (regressions > 0)
+    {
+        QTextStream(stderr) << "ElevatorBench: " << regressions << " scenario(s) more than " << threshold << "% slower than " << baselineFile << ".\n";
+        return 2;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("ElevatorBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the dispatch and stop ordering hot paths and prints nanoseconds and heap allocations per operation.\n"
+                                     "Elevators, floors and pending take comma separated lists, every combination is measured.");
+    parser.addHelpOption();
+    QCommandLineOption carsOption(QStringList() << "e" << "elevators", "Number of elevator cars.", "counts", "4,16,64");
+    QCommandLineOption floorsOption(QStringList() << "f" << "floors", "Number of floors in the building.", "counts", "20,60");
+    QCommandLineOption pendingOption(QStringList() << "p" << "pending", "Hall calls already waiting, or stops already queued in a car.", "counts", "0,8,32");
+    QCommandLineOption strategyOption(QStringList() << "a" << "strategy", "Dispatch strategies for floorRequest and step: " + DispatchStrategyRegistry::instance().names().join(", ") + ", or all.", "names", "closest");
+    QCommandLineOption filterOption("filter", "Only run benchmarks or scenarios whose name contains this text.", "text");
+    QCommandLineOption minTimeOption("min-time", "Milliseconds to time each case for, at least.", "ms", "200");
+    QCommandLineOption csvOption("csv", "Print a header and one comma separated line per case.");
+    QCommandLineOption scenariosOption("scenarios", "Run the office, tower and campus scenarios end to end instead and print simulated seconds and events per wall second.");
+    QCommandLineOption repeatOption("repeat", "Runs of each scenario, the fastest one counts.", "count", "3");
+    QCommandLineOption jsonOption("json", "Save the scenario results to this JSON file.", "file");
+    QCommandLineOption baselineOption("baseline", "Compare the scenarios with results saved by --json.", "file");
+    QCommandLineOption thresholdOption("threshold", "Percent a scenario's throughput can fall below the baseline before the run fails.", "percent", "10");
+    parser.addOption(carsOption);
+    parser.addOption(floorsOption);
+    parser.addOption(pendingOption);
+    parser.addOption(strategyOption);
+    parser.addOption(filterOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(csvOption);
+    parser.addOption(scenariosOption);
+    parser.addOption(repeatOption);
+    parser.addOption(jsonOption);
+    parser.addOption(baselineOption);
+    parser.addOption(thresholdOption);
+    parser.process(a);
+
+    // the control system reports every dispatch decision
+    QLoggingCategory::setFilterRules("default.info=false");
+
+    bool ok = true;
+    if (parser.isSet(scenariosOption))
+    {
+        int repeats = parser.value(repeatOption).toInt(&ok);
+        if (!ok || repeats < 1)
+        {
+            QTextStream(stderr) << "ElevatorBench: repeat must be a number of at least 1.\n";
+            return 1;
+        }
+        double threshold = parser.value(thresholdOption).toDouble(&ok);
+        if (!ok || threshold < 0)
+        {
+            QTextStream(stderr) << "ElevatorBench: threshold must be a non-negative percentage.\n";
+            return 1;
+        }
+        return runScenarios(parser.value(filterOption), repeats, parser.value(jsonOption), parser.value(baselineOption), threshold);
+    }
+
+    QVector<int> cars;
+    QVector<int> floors;
+    QVector<int> pendings;
+    for (const QString &value : parser.value(carsOption).split(','))
+    {
+        cars.push_back(value.toInt(&ok));
+        if (!ok || cars.last() < 1)
+        {
+            QTextStream(stderr) << "ElevatorBench: elevators must be numbers of at least 1.\n";
+            return 1;
+        }
+    }
+    for (const QString &value : parser.value(floorsOption).split(','))
+    {
+        floors.push_back(value.toInt(&ok));
+        if (!ok || floors.last() < 2)
+        {
+            QTextStream(stderr) << "ElevatorBench: floors must be numbers of at least 2.\n";
+            return 1;
+        }
+    }
+    for (const QString &value : parser.value(pendingOption).split(','))
+    {
+        pendings.push_back(value.toInt(&ok));
+        if (!ok || pendings.last() < 0)
+        {
+            QTextStream(stderr) << "ElevatorBench: pending must be non-negative numbers.\n";
+            return 1;
+        }
+    }
+    QStringList strategies = DispatchStrategyRegistry::instance().names();
+    if (parser.value(strategyOption) != "all")
+    {
+        strategies = parser.value(strategyOption).split(',');
+        for (const QString &strategy : strategies)
+        {
+            if (!DispatchStrategyRegistry::instance().names().contains(strategy))
+            {
+                QTextStream(stderr) << "ElevatorBench: unknown dispatch strategy " << strategy << ".\n";
+                return 1;
+            }
+        }
+    }
+    qint64 minMs = parser.value(minTimeOption).toLongLong(&ok);
+    if (!ok || minMs < 1)
+    {
+        QTextStream(stderr) << "ElevatorBench: min-time must be a positive number of milliseconds.\n";
+        return 1;
+    }
+    bool csv = parser.isSet(csvOption);
+    QString filter = parser.value(filterOption);
+
+    QTextStream out(stdout);
+    if (csv)
+    {
+        out << "benchmark,cars,floors,pending,ns_per_op,allocations_per_op\n";
+    }
+    else
+    {
+        out << "allocations counted from " << (AllocationCounter::countsMalloc() ? "malloc" : "operator new") << "\n";
+        out << QString("%1 %2 %3 %4 %5 %6\n").arg("benchmark", -28).arg("cars", 5).arg("floors", 6).arg("pending", 7).arg("ns/op", 12).arg("allocs/op", 10);
+    }
+
+    // name, whether it depends on cars, pending and the strategy, and how to measure one case
+    struct Benchmark
+    {
+        QString name;
+        bool usesCars;
+        bool usesPending;
+        bool usesStrategy;
+        std::function<Measurement(const BenchCase &, qint64)> measure;
+    };
+    QVector<Benchmark> benchmarks;
+    benchmarks.push_back({"floorRequest", true, true, true, benchFloorRequest});
+    benchmarks.push_back({"checkFloorRequests", true, true, false, benchCheckFloorRequests});
+    benchmarks.push_back({"destinationQueue/look", false, true, false, [](const BenchCase &c, qint64 ms) { return benchDestinationQueue(c, ms, queueOrdering::look); }});
+    benchmarks.push_back({"destinationQueue/fifo", false, true, false, [](const BenchCase &c, qint64 ms) { return benchDestinationQueue(c, ms, queueOrdering::fifo); }});
+    benchmarks.push_back({"dispatchCost", true, false, false, benchDispatchCost});
+    benchmarks.push_back({"step", true, false, true, benchStep});
+
+    for (const Benchmark &benchmark : benchmarks)
+    {
+        // parameters a benchmark ignores are measured once
+        QVector<int> carCounts = benchmark.usesCars ? cars : QVector<int>() << 0;
+        QVector<int> pendingCounts = benchmark.usesPending ? pendings : QVector<int>() << 0;
+        QStringList strategyNames = benchmark.usesStrategy ? strategies : QStringList() << "closest";
+        for (const QString &strategy : strategyNames)
+        {
+            QString name = benchmark.usesStrategy ? benchmark.name + "/" + strategy : benchmark.name;
+            if (!filter.isEmpty() && !name.contains(filter))
+            {
+                continue;
+            }
+            for (int carCount : carCounts)
+            {
+                for (int floorCount : floors)
+                {
+                    for (int pending : pendingCounts)
+                    {
+                        BenchCase c = {qMax(carCount, 1), floorCount, pending, strategy};
+                        Measurement m = benchmark.measure(c, minMs);
+                        QString carText = benchmark.usesCars ? QString::number(carCount) : "-";
+                        QString pendingText = benchmark.usesPending ? QString::number(pending) : "-";
+                        if (csv)
+                        {
+                            out << name << "," << carText << "," << floorCount << "," << pendingText << "," << m.nsPerOp << "," << m.allocationsPerOp << "\n";
+                        }
+                        else
+                        {
+                            out << QString("%1 %2 %3 %4 %5 %6\n")
+                                       .arg(name, -28)
+                                       .arg(carText, 5)
+                                       .arg(floorCount, 6)
+                                       .arg(pendingText, 7)
+                                       .arg(m.nsPerOp, 12, 'f', 1)
+                                       .arg(m.allocationsPerOp, 10, 'f', 2);
+                        }
+                        out.flush();
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
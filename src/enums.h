@@ -27,4 +27,58 @@ enum class elevatorState
     occupied
 };
 
+enum class queueOrdering
+{
+    fifo,
+    look
+};
+
+// independent random number streams, drawing from one never shifts what the others give
+enum class randomStream
+{
+    dispatch,
+    maintenance
+};
+
+// an input command given to the building, see SessionLog
+enum class commandType : unsigned char
+{
+    floorRequest,
+    carRequest,
+    helpRequest,
+    openDoorRequest,
+    closeDoorRequest,
+    doorBlocked,
+    overload,
+    fireAlarm,
+    powerOutage
+};
+
+// what happened in one event log record, see EventLog::format for the text of each
+enum class eventType : unsigned char
+{
+    reachedDestination,
+    movedUp,
+    movedDown,
+    stoppingOnTheWay,
+    atEmergencyExit,
+    movedDownEmergencyExit,
+    doorOpened,
+    doorBlocked,
+    overloaded,
+    doorClosed,
+    doorOpenedByRequest,
+    doorBlockedOnRequest,
+    overloadedOnRequest,
+    doorClosedByRequest,
+    helpPressed,
+    connectedToMaintenance,
+    connectedTo911,
+    emergencyExitMessage,
+    fireEmergency,
+    powerOutageEmergency,
+    fireAlarm,
+    powerOutage
+};
+
 #endif // ENUMS_H
@@ -1,11 +1,60 @@
 #include "mainwindow.h"
+#include "TraceRecorder.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
 
-    return a.exec();
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption seedOption("seed", "Start every simulation from this random seed.", "seed");
+    QCommandLineOption recordOption("record", "Save the commands of each simulation to this file when it ends.", "file");
+    QCommandLineOption traceEventsOption("trace-events", "Save timed scopes inside the engine to this file in the chrome trace event format on exit. Needs a build with CONFIG+=tracing.", "file");
+    parser.addOption(seedOption);
+    parser.addOption(recordOption);
+    parser.addOption(traceEventsOption);
+    parser.process(a);
+
+    QString traceEventsFile = parser.value(traceEventsOption);
+    if (!traceEventsFile.isEmpty())
+    {
+        if (!TraceRecorder::isCompiledIn())
+        {
+            QTextStream(stderr) << "ElevatorSimulator: trace-events needs a build with CONFIG+=tracing.\n";
+            return 1;
+        }
+        TraceRecorder::start();
+    }
+
+    int status;
+    {
+        MainWindow w;
+        if (parser.isSet(seedOption))
+        {
+            w.setSeed(parser.value(seedOption).toUInt());
+        }
+        if (parser.isSet(recordOption))
+        {
+            w.setSessionFile(parser.value(recordOption));
+        }
+        w.show();
+
+        status = a.exec();
+    }
+
+    // the window has stopped the engine thread, so nothing is recording any more
+    if (!traceEventsFile.isEmpty())
+    {
+        TraceRecorder::stop();
+        QString error;
+        if (!TraceRecorder::save(traceEventsFile, error))
+        {
+            QTextStream(stderr) << "ElevatorSimulator: " << error << "\n";
+            return 1;
+        }
+    }
+    return status;
 }
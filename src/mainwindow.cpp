@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include <random>
 
 // Static Variables for Elevator number and floor number
 static int elevatorCount;
@@ -9,18 +10,48 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
                                           ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
+
+    // the system log shows a bounded model that is updated once per frame
+    systemLogModel = new SystemLogModel(20000, this);
+    ui->systemLog->setModel(systemLogModel);
+    ui->systemLog->setUniformItemSizes(true);
+    connect(systemLogModel, &SystemLogModel::rowsInserted, ui->systemLog, &QListView::scrollToBottom);
+    ui->systemLogFilter->addItem("All Elevators");
+    appendSystemLog("Select The Number Of Floors And Elevators Then Click The Start Simulation Button", -1);
+
+    // the simulation runs on its own thread so neither side can hold up the other
+    engine = new SimulationEngine;
+    engine->moveToThread(&engineThread);
+    connect(&engineThread, &QThread::finished, engine, &QObject::deleteLater);
+    connect(engine, &SimulationEngine::started, this, &MainWindow::simulationStarted);
+    connect(engine, &SimulationEngine::updated, this, &MainWindow::simulationUpdated);
+    connect(engine, &SimulationEngine::stopped, this, &MainWindow::simulationStopped);
+    engineThread.start();
+
     setUpConnection(); // Connect all the buttons to their respective functions
 }
 
+void MainWindow::setSeed(quint32 seed)
+{
+    this->seed = seed;
+    fixedSeed = true;
+}
+
+void MainWindow::setSessionFile(const QString &fileName)
+{
+    engine->setSessionFile(fileName);
+}
+
 void MainWindow::setUpConnection()
 {
     // connect button to start and simulation
     connect(ui->startSimulationButton, SIGNAL(clicked()), this, SLOT(startSimulation()));
     connect(ui->endSimulationButton, SIGNAL(clicked()), this, SLOT(endSimulation()));
 
-    // make spinbox for number of elevators and floors
+    // make spinbox for number of elevators and floors.
+    // the status bar shows every car, which stays readable up to twenty, bigger buildings run in ElevatorBatch
     ui->elevatorSpinBox->setRange(1, 20);
-    ui->floorSpinBox->setRange(2, 20);
+    ui->floorSpinBox->setRange(2, 100);
 
     // connect floor panel buttons to floor panel slots
     connect(ui->upButton, SIGNAL(clicked()), this, SLOT(upButton()));
@@ -47,6 +78,9 @@ void MainWindow::setUpConnection()
     // connect fire button and power outage button
     connect(ui->fireButton, SIGNAL(clicked()), this, SLOT(fireButton()));
     connect(ui->powerOutageButton, SIGNAL(clicked()), this, SLOT(powerOutageButton()));
+
+    // connect system log filter
+    connect(ui->systemLogFilter, SIGNAL(currentIndexChanged(int)), this, SLOT(filterSystemLog(int)));
 }
 
 void MainWindow::startSimulation()
@@ -55,11 +89,21 @@ void MainWindow::startSimulation()
     elevatorCount = ui->elevatorSpinBox->value();
     floorCount = ui->floorSpinBox->value();
 
-    // reset system log
-    ui->systemLog->clear();
+    // reset system log, with a filter entry for every car
+    systemLogModel->clear();
+    ui->systemLogFilter->clear();
+    ui->systemLogFilter->addItem("All Elevators");
+    for (int i = 1; i <= elevatorCount; i++)
+    {
+        ui->systemLogFilter->addItem("Elevator " + QString::number(i));
+    }
+
+    // a fresh seed every time unless one was given, logged so the run can be repeated
+    quint32 runSeed = fixedSeed ? seed : std::random_device()();
 
     QString q = "Starting Simulation With " + QString::number(elevatorCount) + " Elevators And " + QString::number(floorCount) + " Floors.";
     appendSystemLog(q, -1);
+    appendSystemLog("Random Seed " + QString::number(runSeed) + ".", -1);
 
     // disable button and list widgets after user clicks button
     ui->startSimulationButton->setEnabled(false);
@@ -87,29 +131,21 @@ void MainWindow::startSimulation()
     ui->elevatorPanelCarSpinBox->setEnabled(true);
     ui->elevatorPanelFloorSpinBox->setEnabled(true);
 
-    // create elevator control system
-    ecs = new ElevatorControlSystem(elevatorCount, floorCount);
-
-    // create elevators
-    for (int i = 0; i < elevatorCount; i++)
-    {
-        // start elevators at random floor
-        int randomFloor = rand() % floorCount + 1;
-        ElevatorCar *elevator = new ElevatorCar(i + 1, randomFloor, ecs);
-        elevators.push_back(elevator);
-        ecs->addElevator(elevator);
-    }
-
-    // connect ElevatorControlSystem systemLog signals to MainWindow appendSystemLog slots
-    connect(ecs, &ElevatorControlSystem::log, this, &MainWindow::appendSystemLog);
+    // create elevator control system and elevators on the engine thread
+    endMessage.clear();
+    engine->start(elevatorCount, floorCount, runSeed);
+}
 
+void MainWindow::simulationStarted(QVector<CarSnapshot> cars)
+{
     // display elevators position
-    for (int i = 0; i < elevatorCount; i++)
+    for (int i = 0; i < cars.size(); i++)
     {
-        QString q = "Elevator " + QString::number(i + 1) + " is idle at floor " + QString::number(elevators[i]->getCurrentFloor()) + ".";
+        QString q = "Elevator " + QString::number(i + 1) + " is idle at floor " + QString::number(cars[i].floor) + ".";
         appendSystemLog(q, i + 1);
     }
     appendSystemLog("", -1);
+    showCars(cars);
 }
 
 void MainWindow::endSimulation()
@@ -127,56 +163,78 @@ void MainWindow::endSimulation()
     ui->fireButton->setEnabled(false);
     ui->powerOutageButton->setEnabled(false);
 
-    // enable start simulation button
-    ui->startSimulationButton->setEnabled(true);
-    ui->elevatorSpinBox->setEnabled(true);
-    ui->floorSpinBox->setEnabled(true);
     ui->floorPanelSpinBox->setEnabled(false);
     ui->elevatorPanelCarSpinBox->setEnabled(false);
     ui->elevatorPanelFloorSpinBox->setEnabled(false);
 
-    // delete elevator control system
-    delete ecs;
-    ecs = nullptr;
+    // delete elevator control system and elevators on the engine thread
+    engine->stop();
+}
 
-    // delete elevators
-    for (int i = 0; i < elevators.size(); i++)
+void MainWindow::simulationStopped()
+{
+    // the engine has sent its last events, so the closing messages come after them
+    if (!endMessage.isEmpty())
     {
-        delete elevators[i];
+        appendSystemLog(endMessage, -1);
+        endMessage.clear();
     }
-    elevators.clear();
-
     appendSystemLog("Simulation Ended. You can start the simulation again to reset the elevators.\n", -1);
+    statusBar()->clearMessage();
+
+    // enable start simulation button once the old elevators are gone
+    ui->startSimulationButton->setEnabled(true);
+    ui->elevatorSpinBox->setEnabled(true);
+    ui->floorSpinBox->setEnabled(true);
 }
 
 void MainWindow::appendSystemLog(QString q, int elevatorNumber)
 {
-    // reset color to default
-    ui->systemLog->setTextColor(QColor(0,0,0)); // TODO: change to default color
-    if (elevatorNumber != -1)
+    // the model colors each car's lines
+    systemLogModel->addMessage(q, elevatorNumber);
+}
+
+void MainWindow::simulationUpdated(QVector<LogEvent> events, QVector<CarSnapshot> cars)
+{
+    // events are only formatted once the log view shows them
+    for (const LogEvent &event : events)
     {
-        // switch case to change color of elevator number
-        switch (elevatorNumber)
+        systemLogModel->addEvent(event);
+    }
+    showCars(cars);
+}
+
+void MainWindow::showCars(const QVector<CarSnapshot> &cars)
+{
+    // one short entry per car in the status bar
+    QStringList positions;
+    for (int i = 0; i < cars.size(); i++)
+    {
+        QString state;
+        switch (cars[i].state)
         {
-        case 1:
-            // set color to 00C0FF
-            ui->systemLog->setTextColor(QColor(0, 192, 255));
+        case elevatorState::up:
+            state = "up to " + QString::number(cars[i].destination);
             break;
-        case 2:
-            // set color to 0040FF
-            ui->systemLog->setTextColor(QColor(0, 64, 255));
+        case elevatorState::down:
+            state = "down to " + QString::number(cars[i].destination);
             break;
-
-        case 3:
-            // set color to 0040FF
-            ui->systemLog->setTextColor(QColor(0, 192, 0));
+        case elevatorState::idle:
+            state = "idle";
             break;
-        default:
-            ui->systemLog->setTextColor(QColor(255, 0, 0));
+        case elevatorState::occupied:
+            state = cars[i].door == doorStatus::open ? "door open" : "stopped";
             break;
         }
+        positions.push_back("Elevator " + QString::number(i + 1) + ": floor " + QString::number(cars[i].floor) + " " + state);
     }
-    ui->systemLog->append(q);
+    statusBar()->showMessage(positions.join("  |  "));
+}
+
+void MainWindow::filterSystemLog(int index)
+{
+    // entry 0 shows every car, entry n shows car n
+    systemLogModel->setElevatorFilter(qMax(index, 0));
 }
 
 void MainWindow::upButton()
@@ -194,7 +252,7 @@ void MainWindow::upButton()
     appendSystemLog(q, -1);
 
     // send floor request to elevator control system
-    ecs->floorRequest(floor, direction::up);
+    engine->floorRequest(floor, direction::up);
 }
 
 void MainWindow::downButton()
@@ -211,7 +269,7 @@ void MainWindow::downButton()
     appendSystemLog(q, -1);
 
     // send floor request to elevator control system
-    ecs->floorRequest(floor, direction::down);
+    engine->floorRequest(floor, direction::down);
 }
 
 void MainWindow::requestRideButton()
@@ -222,7 +280,7 @@ void MainWindow::requestRideButton()
     appendSystemLog(q, -1);
 
     // send car request to elevator
-    elevators[car - 1]->carRequest(floor);
+    engine->carRequest(car, floor);
 }
 
 void MainWindow::helpButton()
@@ -232,7 +290,7 @@ void MainWindow::helpButton()
     appendSystemLog(q, -1);
 
     // send help request to elevator
-    elevators[car - 1]->helpRequest();
+    engine->helpRequest(car);
 }
 
 void MainWindow::openDoorButton()
@@ -241,7 +299,7 @@ void MainWindow::openDoorButton()
     int floor = ui->elevatorPanelFloorSpinBox->value();
 
     // send open door request to elevator
-    elevators[car - 1]->openDoorRequest();
+    engine->openDoorRequest(car);
 }
 
 void MainWindow::closeDoorButton()
@@ -250,7 +308,7 @@ void MainWindow::closeDoorButton()
     int floor = ui->elevatorPanelFloorSpinBox->value();
 
     // send close door request to elevator
-    elevators[car - 1]->closeDoorRequest();
+    engine->closeDoorRequest(car);
 }
 
 void MainWindow::doorBlock()
@@ -258,7 +316,7 @@ void MainWindow::doorBlock()
     int car = ui->elevatorPanelCarSpinBox->value();
 
     // send door block request to elevator
-    elevators[car - 1]->setDoorBlocked(true);
+    engine->setDoorBlocked(car, true);
 }
 
 void MainWindow::unblockDoor()
@@ -266,7 +324,7 @@ void MainWindow::unblockDoor()
     int car = ui->elevatorPanelCarSpinBox->value();
 
     // send door unblock request to elevator
-    elevators[car - 1]->setDoorBlocked(false);
+    engine->setDoorBlocked(car, false);
 }
 
 void MainWindow::overload()
@@ -274,7 +332,7 @@ void MainWindow::overload()
     int car = ui->elevatorPanelCarSpinBox->value();
 
     // send overload request to elevator
-    elevators[car - 1]->setOverload(true);
+    engine->setOverload(car, true);
 }
 
 void MainWindow::unOverload()
@@ -282,16 +340,16 @@ void MainWindow::unOverload()
     int car = ui->elevatorPanelCarSpinBox->value();
 
     // send unoverload request to elevator
-    elevators[car - 1]->setOverload(false);
+    engine->setOverload(car, false);
 }
 
 void MainWindow::fireButton()
 {
     // send fire alarm to elevator control system
-    ecs->fireAlarm();
+    engine->fireAlarm();
 
-    // log fire alarm
-    appendSystemLog("\nDue to a fire alarm, all elevators operations have been suspended until further notice.\n", -1);
+    // log fire alarm after the elevators have reported in
+    endMessage = "\nDue to a fire alarm, all elevators operations have been suspended until further notice.\n";
 
     endSimulation();
 }
@@ -299,20 +357,18 @@ void MainWindow::fireButton()
 void MainWindow::powerOutageButton()
 {
     // send power outage to elevator control system
-    ecs->powerOutage();
+    engine->powerOutage();
 
-    // log power outage
-    appendSystemLog("\nDue to a power outage, all elevators operations have been suspended until further notice.\nYou can start the simulation again to reset the elevators.\n", -1);
+    // log power outage after the elevators have reported in
+    endMessage = "\nDue to a power outage, all elevators operations have been suspended until further notice.\nYou can start the simulation again to reset the elevators.\n";
 
     endSimulation();
 }
 
 MainWindow::~MainWindow()
 {
-    delete ecs;
+    // stop the engine thread, the engine and its elevators are deleted as it finishes
+    engineThread.quit();
+    engineThread.wait();
     delete ui;
-    for (int i = 0; i < elevators.size(); i++)
-    {
-        delete elevators[i];
-    }
 }
@@ -1,11 +1,12 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 #include <QMainWindow>
-#include "ElevatorControlSystem.h"
-#include "ElevatorCar.h"
+#include "SimulationEngine.h"
+#include "SystemLogModel.h"
 #include "ui_mainwindow.h"
 #include "enums.h"
 #include <QObject>
+#include <QThread>
 
 namespace Ui
 {
@@ -20,6 +21,12 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // every simulation starts from this seed instead of a fresh random one
+    void setSeed(quint32 seed);
+
+    // save each simulation's commands here when it ends, for replaying with ElevatorBatch --replay
+    void setSessionFile(const QString &fileName);
+
 private slots:
     void startSimulation();
     void endSimulation();
@@ -42,13 +49,23 @@ private slots:
     void overload();
     void unOverload();
 
+    void filterSystemLog(int index);
+
 public slots:
     void appendSystemLog(QString q, int elevatorId);
+    void simulationStarted(QVector<CarSnapshot> cars);
+    void simulationUpdated(QVector<LogEvent> events, QVector<CarSnapshot> cars);
+    void simulationStopped();
 
 private:
     Ui::MainWindow *ui;
-    ElevatorControlSystem *ecs;
-    QVector<ElevatorCar *> elevators;
+    QThread engineThread;
+    SimulationEngine *engine;
+    SystemLogModel *systemLogModel;
+    QString endMessage; // why the simulation ended, shown once the engine has stopped
+    bool fixedSeed = false;
+    quint32 seed = 0;
+    void showCars(const QVector<CarSnapshot> &cars);
     void setUpConnection();
 };
 